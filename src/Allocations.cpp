@@ -0,0 +1,190 @@
+#include <Allocations.hpp>
+#include <WPILib.h>
+#include <atomic>
+#include <execinfo.h>
+#include <new>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace Allocations
+{
+	const int MAX_SITES = 64;
+	const int SKIPPED_FRAMES = 2; // record and operator new
+	const int SITE_FRAMES = 3; // return addresses that make up a call site
+
+	struct Site {
+		void* frames[SITE_FRAMES];
+		uint32_t count;
+		uint32_t bytes;
+	};
+
+	// none of this can need constructing, since allocations start before main
+	Site sites[MAX_SITES];
+	int site_count = 0;
+	uint32_t total_count = 0;
+	uint32_t dropped_count = 0; // allocations from sites that didn't fit
+	std::atomic_flag sites_lock = ATOMIC_FLAG_INIT;
+
+	std::atomic<bool> trapping(false);
+	thread_local bool counting = false;
+	thread_local bool recording = false; // stops allocations made while recording from being recorded
+
+	__attribute__((noinline)) void record(size_t size)
+	{
+		if (!counting || recording) {
+			return;
+		}
+		if (trapping.load(std::memory_order_relaxed)) {
+			__builtin_trap();
+		}
+		recording = true;
+
+		void* frames[SKIPPED_FRAMES + SITE_FRAMES] = { nullptr };
+		int frame_count = backtrace(frames, SKIPPED_FRAMES + SITE_FRAMES);
+
+		while (sites_lock.test_and_set(std::memory_order_acquire)) {
+			// spin, only the report ever holds the lock for long
+		}
+
+		int site = 0;
+		for (; site < site_count; ++site) {
+			bool same = true;
+			for (int i = 0; i < SITE_FRAMES; ++i) {
+				same = same && sites[site].frames[i] == frames[SKIPPED_FRAMES + i];
+			}
+			if (same) {
+				break;
+			}
+		}
+		if (site == site_count && site_count < MAX_SITES) {
+			for (int i = 0; i < SITE_FRAMES; ++i) {
+				sites[site].frames[i] = SKIPPED_FRAMES + i < frame_count ? frames[SKIPPED_FRAMES + i] : nullptr;
+			}
+			sites[site].count = 0;
+			sites[site].bytes = 0;
+			++site_count;
+		}
+
+		if (site < site_count) {
+			++sites[site].count;
+			sites[site].bytes += size;
+		}
+		else {
+			++dropped_count;
+		}
+		++total_count;
+
+		sites_lock.clear(std::memory_order_release);
+		recording = false;
+	}
+
+	void startCounting()
+	{
+		// the first backtrace loads the unwinder, which allocates
+		void* frames[SITE_FRAMES];
+		backtrace(frames, SITE_FRAMES);
+
+		clear();
+		counting = true;
+	}
+
+	void trap(bool enable)
+	{
+		trapping.store(enable, std::memory_order_relaxed);
+	}
+
+	void clear()
+	{
+		while (sites_lock.test_and_set(std::memory_order_acquire)) {
+		}
+		site_count = 0;
+		total_count = 0;
+		dropped_count = 0;
+		sites_lock.clear(std::memory_order_release);
+	}
+
+	unsigned int getCount()
+	{
+		return total_count;
+	}
+
+	void report()
+	{
+		Site reported[MAX_SITES];
+		while (sites_lock.test_and_set(std::memory_order_acquire)) {
+		}
+		int reported_count = site_count;
+		for (int i = 0; i < site_count; ++i) {
+			reported[i] = sites[i];
+		}
+		uint32_t reported_total = total_count;
+		uint32_t reported_dropped = dropped_count;
+		site_count = 0;
+		total_count = 0;
+		dropped_count = 0;
+		sites_lock.clear(std::memory_order_release);
+
+		if (reported_total == 0) {
+			return;
+		}
+
+		// reporting allocates too
+		bool was_recording = recording;
+		recording = true;
+
+		char message[128];
+		snprintf(message, sizeof(message), "%u heap allocations in the loop, from %d call sites (%u from sites not kept)",
+			reported_total, reported_count, reported_dropped);
+		DriverStation::ReportError(message);
+		for (int i = 0; i < reported_count; ++i) {
+			snprintf(message, sizeof(message), "%u allocations, %u bytes, at %p %p %p",
+				reported[i].count, reported[i].bytes, reported[i].frames[0], reported[i].frames[1], reported[i].frames[2]);
+			DriverStation::ReportError(message);
+		}
+
+		recording = was_recording;
+	}
+}
+
+void* operator new(size_t size)
+{
+	Allocations::record(size);
+	void* memory = malloc(size != 0 ? size : 1);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	Allocations::record(size);
+	void* memory = malloc(size != 0 ? size : 1);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	Allocations::record(size);
+	return malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	Allocations::record(size);
+	return malloc(size != 0 ? size : 1);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
@@ -0,0 +1,49 @@
+#ifndef SRC_ALLOCATIONS_H_
+#define SRC_ALLOCATIONS_H_
+
+/**
+ * Counts the heap allocations made by the main thread once the robot is
+ * running, to keep the control loops free of them.
+ *
+ * Every operator new in the program goes through here.  Once startCounting
+ * is called at the end of RobotInit, each one made on the main thread is
+ * counted against its call site, the few return addresses above it, which
+ * report sends to the driver station.  Resolve them with
+ *   arm-frc-linux-gnueabi-addr2line -f -C -e FRCUserProgram <addresses>
+ *
+ * With the trap set, the first such allocation stops the program instead,
+ * so that a debugger lands right on it.
+ *
+ * The navX and other background threads aren't counted, and neither is
+ * malloc called directly, from C code like fopen.
+ */
+namespace Allocations
+{
+	/**
+	 * Starts counting the allocations made on the calling thread
+	 */
+	void startCounting();
+
+	/**
+	 * Sets whether an allocation on the counted thread stops the program
+	 */
+	void trap(bool enable);
+
+	/**
+	 * Forgets every allocation counted so far
+	 */
+	void clear();
+
+	/**
+	 * Returns the number of allocations counted since the last clear or report
+	 */
+	unsigned int getCount();
+
+	/**
+	 * Reports every call site that allocated since the last clear or report to
+	 * the driver station, and then clears them
+	 */
+	void report();
+}
+
+#endif /* SRC_ALLOCATIONS_H_ */
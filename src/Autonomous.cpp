@@ -1,32 +1,133 @@
 #include <Autonomous.hpp>
+#include <Coordination.hpp>
+#include <ED/Trajectory.hpp>
+#include <ED/TrajectoryCache.hpp>
+#include <ED/TrajectoryGenerator.hpp>
+#include <ED/Utils.hpp>
+#include <Routes.hpp>
+#include <Subsystems/Cameras.hpp>
+#include <Subsystems/Mobility.hpp>
+#include <Subsystems/Odometry.hpp>
+#include <Subsystems/Sensors.hpp>
+#include <Subsystems/ShooterPitch.hpp>
+#include <Subsystems/ShooterWheels.hpp>
+#include <WPILib.h>
+
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
 
 namespace Autonomous
 {
+	/*
+	 * Every play is a list of steps.  Steps run one after another, except that a
+	 * step marked with_next starts in the same tick as the step after it, and
+	 * the whole group of steps started together must finish before the next
+	 * step starts.  When a group finishes, the next group starts in the same
+	 * tick, so no time is lost between steps.
+	 */
+	enum Action {
+		DRIVE_ROUTE, // follow the trajectory of a route
+		TURN_TO_HEADING, // value: degrees
+		TURN_TO_GOAL, // face the goal from wherever the robot is
+		SET_PITCH, // value: degrees
+		SPIN_UP, // value: rpm
+		SHOOT, // value: rpm
+		WAIT, // value: seconds
+		WAIT_UNTIL // wait for condition
+	};
+	
+	enum Condition {
+		NO_CONDITION,
+		BALL_LOADED,
+		SEES_GOAL,
+		SHOOTER_AT_RATE,
+		SHOOTER_AT_ANGLE
+	};
+	
+	struct Step {
+		Action action;
+		float value;
+		const ED::Trajectory* trajectory;
+		Condition condition;
+		bool with_next;
+		float timeout; // seconds, or 0.0 to wait as long as it takes
+	};
+	
+	const int MAX_STEPS = 16;
+	const float AUTONOMOUS_LENGTH = 15.0; // seconds
+	
+	const float ROUTE_TOLERANCE = 30.0; // cm a route may start from where the robot should be
+	const float ROUTE_TIMEOUT = 1.0; // seconds a route may run over its planned length
+	const float TURN_TIMEOUT = 2.0;
+	const float PITCH_TIMEOUT = 2.0;
+	const float SPIN_UP_TIMEOUT = 3.0;
+	const float SHOOT_TIMEOUT = 4.0;
+	
+	const float LOW_GOAL_PITCH = 0.0; // TODO: tune
+	const float HIGH_GOAL_PITCH = 45.0; // TODO: tune
+	
+	ED::TrajectoryCache* cache;
+	const ED::Trajectory* trajectories[Routes::MAX_ROUTES];
+	
 	int position = 0;
 	int defense = 0;
 	int shoot = 0;
 	
 	Play play = Play::DO_NOTHING;
-	int stage = 0;
 	
-	void moveToDefense();
-	void crossDefense();
-	void crossDefenseShoot();
-	void spyBotShoot();
-	void spyBotShootReach();
+	Step steps[MAX_STEPS];
+	int step_count = 0;
+	int current_step = 0;
+	int group_end = 0; // one past the last step of the running group, 0 if none is running
+	bool step_finished[MAX_STEPS];
+	double group_start_time = 0.0;
 	
-	void initialize(int position, int defense, int shoot)
+	const ED::Trajectory* getTrajectory(Play play, int position);
+	int getStartPosition(Play play, int position);
+	void buildPlay();
+	void addStep(Action action, float value, float timeout, bool with_next);
+	void addRoute(Play route_play, int route_position, bool with_next);
+	void addWaitUntil(Condition condition, float timeout, bool with_next);
+	void validate();
+	void startGroup();
+	void startStep(const Step& step);
+	bool isStepFinished(const Step& step, float elapsed);
+	bool isConditionMet(Condition condition);
+	void interruptStep(const Step& step);
+	void reportStepError(int index, const char* problem);
+	
+	void loadTrajectories()
 	{
-		stage = 0;
+		cache = new ED::TrajectoryCache();
+		if (cache->load(Routes::CACHE_PATH, Routes::getChecksum()) && cache->getCount() == Routes::getRouteCount()) {
+			for (int i = 0; i < Routes::getRouteCount(); ++i) {
+				trajectories[i] = cache->get(i);
+			}
+			return;
+		}
 		
+		// much better to be slow now than in the middle of a match
+		DriverStation::ReportError("trajectory cache is missing or out of date, run TrajectoryBuilder; generating routes");
+		ED::TrajectoryGenerator* generator = new ED::TrajectoryGenerator(Routes::getLimits(), Routes::getPeriod());
+		for (int i = 0; i < Routes::getRouteCount(); ++i) {
+			ED::Trajectory* trajectory = new ED::Trajectory();
+			if (!Routes::generate(i, *generator, *trajectory)) {
+				trajectory->clear(Routes::getPeriod());
+			}
+			trajectories[i] = trajectory;
+		}
+		delete generator;
+	}
+	
+	void initialize(int position, int defense, int shoot)
+	{
 		Autonomous::position = position;
 		Autonomous::defense = defense;
 		Autonomous::shoot = shoot;
 		
-		if (position == 0 && defense == 0 && shoot == 0) {
-			play = Play::DO_NOTHING;
-		}
-		else if (position != 0 && defense == 0 && shoot == 0) {
+		play = Play::DO_NOTHING;
+		if (position != 0 && defense == 0 && shoot == 0) {
 			play = Play::MOVE_TO_DEFENSE;
 		}
 		else if (position != 0 && defense != 0 && shoot == 0) {
@@ -41,58 +142,356 @@ namespace Autonomous
 		else if (position != 0 && defense == 0 && (shoot == 1 || shoot == 2)) {
 			play = Play::SPY_BOT_SHOOT_REACH;
 		}
+		
+		// every play measures from where the robot starts the match
+		int start = getStartPosition(play, position);
+		Odometry::reset(Routes::START_X[start], Routes::START_Y[start], 0.0);
+		
+		buildPlay();
+		validate();
+		
+		current_step = 0;
+		group_end = 0;
 	}
 	
 	void process()
 	{
+		// finishing a group starts the next one in the same tick
+		while (current_step < step_count) {
+			if (group_end == 0) {
+				startGroup();
+			}
+			
+			float elapsed = Timer::GetFPGATimestamp() - group_start_time;
+			bool finished = true;
+			for (int i = current_step; i < group_end; ++i) {
+				// once a step is done it stays done, even if its condition wavers
+				if (!step_finished[i]) {
+					step_finished[i] = isStepFinished(steps[i], elapsed);
+					finished = finished && step_finished[i];
+				}
+			}
+			if (!finished) {
+				return;
+			}
+			
+			current_step = group_end;
+			group_end = 0;
+		}
+	}
+	
+	Play getPlay()
+	{
+		return play;
+	}
+	
+	bool isFinished()
+	{
+		return current_step >= step_count;
+	}
+	
+	void buildPlay()
+	{
+		step_count = 0;
+		float shot_rate = ShooterWheels::getRPMPreset(ShooterWheels::getPresetCount() - 1);
+		float shot_pitch = shoot == 2 ? HIGH_GOAL_PITCH : LOW_GOAL_PITCH;
+		
 		switch (play) {
-		case Play::MOVE_TO_DEFENSE:
-			moveToDefense();
+		case Play::DO_NOTHING:
 			break;
 		
+		case Play::MOVE_TO_DEFENSE:
 		case Play::CROSS_DEFENSE:
-			crossDefense();
+			addRoute(play, position, false);
 			break;
 		
 		case Play::CROSS_DEFENSE_SHOOT:
-			crossDefenseShoot();
+			// aim and spin up while driving, then square up to the goal and shoot
+			addRoute(play, position, true);
+			addStep(Action::SET_PITCH, shot_pitch, PITCH_TIMEOUT, true);
+			addStep(Action::SPIN_UP, shot_rate, SPIN_UP_TIMEOUT, false);
+			addStep(Action::TURN_TO_GOAL, 0.0, TURN_TIMEOUT, false);
+			addStep(Action::SHOOT, shot_rate, SHOOT_TIMEOUT, false);
 			break;
 		
 		case Play::SPY_BOT_SHOOT:
-			spyBotShoot();
-			break;
-		
 		case Play::SPY_BOT_SHOOT_REACH:
-			spyBotShootReach();
+			addRoute(Play::SPY_BOT_SHOOT, 0, true);
+			addStep(Action::SET_PITCH, shot_pitch, PITCH_TIMEOUT, true);
+			addStep(Action::SPIN_UP, shot_rate, SPIN_UP_TIMEOUT, false);
+			addWaitUntil(Condition::BALL_LOADED, 0.5, false);
+			addStep(Action::SHOOT, shot_rate, SHOOT_TIMEOUT, false);
+			if (play == Play::SPY_BOT_SHOOT_REACH) {
+				addRoute(play, position, false);
+			}
 			break;
-		
-		case Play::DO_NOTHING:
-			return;
 		}
 	}
 	
-	void moveToDefense()
+	int getStartPosition(Play play, int position)
+	{
+		// the spy bot starts in the courtyard whichever defense it reaches for
+		if (play == Play::SPY_BOT_SHOOT || play == Play::SPY_BOT_SHOOT_REACH) {
+			return 0;
+		}
+		return ED::boundsCheck(position, 0, Routes::START_POSITIONS - 1);
+	}
+	
+	void addStep(Action action, float value, float timeout, bool with_next)
+	{
+		if (step_count < MAX_STEPS) {
+			Step& step = steps[step_count++];
+			step.action = action;
+			step.value = value;
+			step.trajectory = nullptr;
+			step.condition = Condition::NO_CONDITION;
+			step.with_next = with_next;
+			step.timeout = timeout;
+		}
+	}
+	
+	void addRoute(Play route_play, int route_position, bool with_next)
 	{
+		const ED::Trajectory* trajectory = getTrajectory(route_play, route_position);
+		float timeout = trajectory != nullptr ? trajectory->getDuration() + ROUTE_TIMEOUT : 0.0;
+		addStep(Action::DRIVE_ROUTE, 0.0, timeout, with_next);
+		if (step_count > 0) {
+			steps[step_count - 1].trajectory = trajectory;
+		}
+	}
+	
+	void addWaitUntil(Condition condition, float timeout, bool with_next)
+	{
+		addStep(Action::WAIT_UNTIL, 0.0, timeout, with_next);
+		if (step_count > 0) {
+			steps[step_count - 1].condition = condition;
+		}
+	}
+	
+	void validate()
+	{
+		/*
+		 * Catch every mistake now, while the robot is still sitting still, rather
+		 * than halfway across the field.  A play is cut short at its first bad
+		 * step, so the robot still does everything before it.
+		 */
+		int start = getStartPosition(play, position);
+		float x = Routes::START_X[start];
+		float y = Routes::START_Y[start];
+		float duration = 0.0;
+		float group_duration = 0.0;
+		bool group_drives = false;
+		bool group_spins = false;
+		for (int i = 0; i < step_count; ++i) {
+			const Step& step = steps[i];
+			
+			// two steps at once can't both have the same subsystem
+			bool drives = step.action == Action::DRIVE_ROUTE || step.action == Action::TURN_TO_HEADING || step.action == Action::TURN_TO_GOAL;
+			bool spins = step.action == Action::SPIN_UP || step.action == Action::SHOOT;
+			if ((drives && group_drives) || (spins && group_spins)) {
+				reportStepError(i, "uses a subsystem already in use by a step running with it");
+				step_count = i;
+				return;
+			}
+			group_drives = group_drives || drives;
+			group_spins = group_spins || spins;
+			
+			switch (step.action) {
+			case Action::DRIVE_ROUTE:
+				if (step.trajectory == nullptr || step.trajectory->getCount() == 0) {
+					reportStepError(i, "has no route");
+					step_count = i;
+					return;
+				}
+				if (hypot(step.trajectory->getSample(0).x - x, step.trajectory->getSample(0).y - y) > ROUTE_TOLERANCE) {
+					reportStepError(i, "starts a route away from where the robot will be");
+					step_count = i;
+					return;
+				}
+				x = step.trajectory->getSample(step.trajectory->getCount() - 1).x;
+				y = step.trajectory->getSample(step.trajectory->getCount() - 1).y;
+				break;
+			
+			case Action::SET_PITCH:
+				if (!ED::valueInRange(step.value, ShooterPitch::getAnglePreset(0) - 0.001,
+				    ShooterPitch::getAnglePreset(ShooterPitch::getPresetCount() - 1) + 0.001)) {
+					reportStepError(i, "sets the shooter past its limits");
+					step_count = i;
+					return;
+				}
+				break;
+			
+			case Action::SPIN_UP:
+			case Action::SHOOT:
+				if (step.value <= 0.0) {
+					reportStepError(i, "spins the shooter wheels at no speed");
+					step_count = i;
+					return;
+				}
+				break;
+			
+			case Action::WAIT_UNTIL:
+				if (step.condition == Condition::NO_CONDITION || step.timeout <= 0.0) {
+					reportStepError(i, "could wait forever");
+					step_count = i;
+					return;
+				}
+				break;
+			
+			case Action::TURN_TO_HEADING:
+			case Action::TURN_TO_GOAL:
+			case Action::WAIT:
+				break;
+			}
+			
+			float step_duration = step.action == Action::WAIT ? step.value : step.timeout;
+			group_duration = fmax(group_duration, step_duration);
+			if (!step.with_next) {
+				duration += group_duration;
+				group_duration = 0.0;
+				group_drives = false;
+				group_spins = false;
+			}
+		}
 		
+		if (duration > AUTONOMOUS_LENGTH) {
+			char message[128];
+			snprintf(message, sizeof(message), "autonomous play %d could take up to %.1f seconds", play, duration);
+			DriverStation::ReportError(message);
+		}
+	}
+	
+	void startGroup()
+	{
+		group_end = current_step;
+		do {
+			startStep(steps[group_end]);
+			step_finished[group_end] = false;
+			++group_end;
+		} while (steps[group_end - 1].with_next && group_end < step_count);
+		group_start_time = Timer::GetFPGATimestamp();
 	}
 	
-	void crossDefense()
+	void startStep(const Step& step)
 	{
+		float heading;
+		switch (step.action) {
+		case Action::DRIVE_ROUTE:
+			Mobility::followTrajectory(step.trajectory);
+			break;
+		
+		case Action::TURN_TO_HEADING:
+			Mobility::turnToHeading(step.value);
+			break;
+		
+		case Action::TURN_TO_GOAL:
+			// turn the short way, keeping the heading continuous
+			heading = atan2(Odometry::GOAL_Y - Odometry::getY(), Odometry::GOAL_X - Odometry::getX()) * 180.0 / M_PI;
+			Mobility::turnToHeading(Odometry::getHeading() + ED::wrap(heading - Odometry::getHeading(), -180.0, 180.0));
+			break;
+		
+		case Action::SET_PITCH:
+			ShooterPitch::goToAngle(step.value);
+			break;
+		
+		case Action::SPIN_UP:
+			ShooterWheels::setRate(step.value);
+			break;
+		
+		case Action::SHOOT:
+			Coordination::shootBall(step.value);
+			break;
 		
+		case Action::WAIT:
+		case Action::WAIT_UNTIL:
+			break;
+		}
 	}
 	
-	void crossDefenseShoot()
+	bool isStepFinished(const Step& step, float elapsed)
 	{
+		if (step.timeout > 0.0 && elapsed > step.timeout) {
+			interruptStep(step);
+			return true;
+		}
+		
+		switch (step.action) {
+		case Action::DRIVE_ROUTE:
+		case Action::TURN_TO_HEADING:
+		case Action::TURN_TO_GOAL:
+			return Mobility::getState() == Mobility::State::WAITING;
+		
+		case Action::SET_PITCH:
+			return ShooterPitch::atAngle();
+		
+		case Action::SPIN_UP:
+			return ShooterWheels::atRate();
 		
+		case Action::SHOOT:
+			return Coordination::getState() == Coordination::State::WAITING;
+		
+		case Action::WAIT:
+			return elapsed >= step.value;
+		
+		case Action::WAIT_UNTIL:
+			return isConditionMet(step.condition);
+		}
+		return true;
 	}
 	
-	void spyBotShoot()
+	bool isConditionMet(Condition condition)
 	{
+		switch (condition) {
+		case Condition::NO_CONDITION:
+			return true;
+		
+		case Condition::BALL_LOADED:
+			return Sensors::isBallLimitPressed();
+		
+		case Condition::SEES_GOAL:
+			return Cameras::canSeeGoal();
+		
+		case Condition::SHOOTER_AT_RATE:
+			return ShooterWheels::atRate();
 		
+		case Condition::SHOOTER_AT_ANGLE:
+			return ShooterPitch::atAngle();
+		}
+		return true;
 	}
 	
-	void spyBotShootReach()
+	void interruptStep(const Step& step)
 	{
+		// a step that ran out of time mustn't keep driving into the next one
+		switch (step.action) {
+		case Action::DRIVE_ROUTE:
+		case Action::TURN_TO_HEADING:
+		case Action::TURN_TO_GOAL:
+			Mobility::interrupt();
+			break;
+		
+		case Action::SHOOT:
+			Coordination::interrupt();
+			break;
 		
+		case Action::SET_PITCH:
+		case Action::SPIN_UP:
+		case Action::WAIT:
+		case Action::WAIT_UNTIL:
+			break; // holding the pitch or wheel speed doesn't hurt
+		}
+	}
+	
+	void reportStepError(int index, const char* problem)
+	{
+		char message[128];
+		snprintf(message, sizeof(message), "autonomous play %d step %d %s, stopping the play there", play, index, problem);
+		DriverStation::ReportError(message);
+	}
+	
+	const ED::Trajectory* getTrajectory(Play play, int position)
+	{
+		int index = Routes::findRoute(play, position);
+		return index >= 0 ? trajectories[index] : nullptr;
 	}
 }
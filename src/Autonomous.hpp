@@ -12,8 +12,27 @@ namespace Autonomous
 		SPY_BOT_SHOOT_REACH
 	};
 	
+	/**
+	 * Maps the pregenerated route trajectories into memory, or generates them if
+	 * the file is missing or out of date.  Call once when the robot boots, so
+	 * that choosing a play at the start of a match costs nothing.
+	 */
+	void loadTrajectories();
+
+	/**
+	 * Chooses a play from the autonomous switches and checks that every step of
+	 * it can be carried out
+	 */
 	void initialize(int position, int defense, int shoot);
+
+	/**
+	 * Runs the steps of the play, starting each as soon as the ones before it
+	 * are finished
+	 */
 	void process();
+
+	Play getPlay();
+	bool isFinished();
 }
 
 #endif // SRC_AUTONOMOUS_H_
@@ -0,0 +1,196 @@
+#include <Characterization.hpp>
+#include <ED/DriveCharacterizer.hpp>
+#include <Subsystems/Mobility.hpp>
+#include <Subsystems/PowerBudget.hpp>
+#include <Subsystems/Sensors.hpp>
+#include <Utils.hpp>
+#include <WPILib.h>
+#include <stdio.h>
+
+namespace Characterization
+{
+	/*
+	 * The gains file has one line, the ks, kv, ka and effective wheelbase of
+	 * the drive train, separated by spaces.  The log has a line per sample.
+	 */
+	const char* const GAINS_PATH = "/home/lvuser/drive_gains.txt";
+	const char* const LOG_PATH = "/home/lvuser/drive_characterization.csv";
+
+	const float SAMPLE_PERIOD = 0.005; // seconds, about as often as the navX updates
+
+	struct Test {
+		const char* name;
+		float output; // at the start of the test
+		float ramp; // output per second
+		float duration; // seconds
+		bool turning; // spins clockwise in place, rather than driving straight
+		bool logged;
+	};
+
+	const float REST_TIME = 2.0; // seconds, for the robot to coast to a stop
+
+	const Test TESTS[] = {
+		{ "quasistatic forward", 0.0, 0.05, 7.0, false, true },
+		{ "rest", 0.0, 0.0, REST_TIME, false, false },
+		{ "quasistatic backward", 0.0, -0.05, 7.0, false, true },
+		{ "rest", 0.0, 0.0, REST_TIME, false, false },
+		{ "dynamic forward", 0.5, 0.0, 2.0, false, true },
+		{ "rest", 0.0, 0.0, REST_TIME, false, false },
+		{ "dynamic backward", -0.5, 0.0, 2.0, false, true },
+		{ "rest", 0.0, 0.0, REST_TIME, false, false },
+		{ "spin", 0.4, 0.0, 3.0, true, true },
+		{ "rest", 0.0, 0.0, REST_TIME, false, false }
+	};
+	const int TEST_COUNT = sizeof(TESTS) / sizeof(*TESTS);
+
+	ED::DriveCharacterizer* characterizer;
+	Timer* test_timer;
+	Timer* log_timer;
+	int test = -1; // the test running, or -1 for none
+	float last_sample_time = 0.0;
+
+	void finish();
+	bool loadGains();
+	bool saveGains(const Mobility::DriveGains& gains);
+
+	void initialize()
+	{
+		characterizer = new ED::DriveCharacterizer();
+		test_timer = Utils::constructTimer();
+		log_timer = Utils::constructTimer();
+
+		loadGains();
+	}
+
+	void process()
+	{
+		if (test < 0) {
+			return;
+		}
+
+		float time = test_timer->Get();
+		if (time >= TESTS[test].duration) {
+			++test;
+			test_timer->Reset();
+			time = 0.0;
+			if (test == TEST_COUNT) {
+				finish();
+				return;
+			}
+		}
+
+		const Test& current = TESTS[test];
+		float output = current.output + current.ramp * time;
+		Mobility::setLeftSpeed(output);
+		Mobility::setRightSpeed(current.turning ? -output : output);
+
+		float log_time = log_timer->Get();
+		if (current.logged && log_time - last_sample_time >= SAMPLE_PERIOD) {
+			last_sample_time = log_time;
+
+			// what actually reaches the motors, after any power budget cut
+			float applied_output = output * PowerBudget::getScale(PowerBudget::Consumer::MOBILITY);
+			ED::DriveCharacterizer::Sample sample = {
+				log_time,
+				applied_output,
+				current.turning ? -applied_output : applied_output,
+				Sensors::getLeftEncoderDistance(),
+				Sensors::getRightEncoderDistance(),
+				Sensors::getLeftEncoderSpeed(),
+				Sensors::getRightEncoderSpeed(),
+				Sensors::getRobotTurnRate(),
+				current.turning
+			};
+			characterizer->record(sample);
+		}
+	}
+
+	void start()
+	{
+		stop();
+		if (!Sensors::areDriveEncodersEnabled() || !Sensors::isGyroEnabled()) {
+			DriverStation::ReportError("can't characterize the drive train without its encoders and the gyro");
+			return;
+		}
+
+		// the encoders and motors then both face the physical front
+		Mobility::useNormalOrientation(true);
+		characterizer->clear();
+		test = 0;
+		test_timer->Reset();
+		test_timer->Start();
+		log_timer->Reset();
+		log_timer->Start();
+		last_sample_time = -SAMPLE_PERIOD;
+
+		DriverStation::ReportError("characterizing the drive train, stand clear");
+	}
+
+	void stop()
+	{
+		if (test >= 0) {
+			Mobility::setStraight(0.0);
+			test = -1;
+		}
+	}
+
+	bool isRunning()
+	{
+		return test >= 0;
+	}
+
+	void finish()
+	{
+		Mobility::setStraight(0.0);
+		test = -1;
+
+		if (!characterizer->write(LOG_PATH)) {
+			DriverStation::ReportError("couldn't save the drive characterization log");
+		}
+
+		char message[192];
+		Mobility::DriveGains gains = Mobility::getDriveGains();
+		if (characterizer->fit(gains)) {
+			Mobility::setDriveGains(gains);
+			saveGains(gains);
+			snprintf(message, sizeof(message), "characterized the drive train from %d samples: ks %g, kv %g, ka %g, wheelbase %.1f cm",
+				characterizer->getCount(), gains.ks, gains.kv, gains.ka, gains.wheelbase);
+		}
+		else {
+			snprintf(message, sizeof(message), "couldn't characterize the drive train from %d samples, the gains are unchanged",
+				characterizer->getCount());
+		}
+		DriverStation::ReportError(message);
+	}
+
+	bool loadGains()
+	{
+		FILE* file = fopen(GAINS_PATH, "r");
+		if (file == nullptr) {
+			return false; // the gains in the code are used until the drive train is characterized
+		}
+
+		Mobility::DriveGains gains;
+		bool loaded = fscanf(file, "%f %f %f %f", &gains.ks, &gains.kv, &gains.ka, &gains.wheelbase) == 4;
+		fclose(file);
+		if (loaded) {
+			Mobility::setDriveGains(gains);
+		}
+		else {
+			DriverStation::ReportError("couldn't read the drive gains file");
+		}
+		return loaded;
+	}
+
+	bool saveGains(const Mobility::DriveGains& gains)
+	{
+		FILE* file = fopen(GAINS_PATH, "w");
+		if (file == nullptr) {
+			DriverStation::ReportError("couldn't save the drive gains file");
+			return false;
+		}
+		fprintf(file, "%.9g %.9g %.9g %.9g\n", gains.ks, gains.kv, gains.ka, gains.wheelbase);
+		fclose(file);
+		return true;
+	}
+}
@@ -0,0 +1,30 @@
+#ifndef SRC_CHARACTERIZATION_H_
+#define SRC_CHARACTERIZATION_H_
+
+/**
+ * Finds the feedforward gains and effective wheelbase of the drive train in
+ * test mode with ED::DriveCharacterizer, and keeps them in a file on the
+ * roboRIO for Mobility.
+ *
+ * The robot drives itself through a series of tests, so it needs a few
+ * meters of clear floor ahead of and behind it: a slow ramp of output
+ * forwards and then backwards, a sudden step forwards and then backwards,
+ * and a spin in place, with a rest between each.  Every loop of each test is
+ * logged, and at the end the gains are fit, handed to Mobility, saved, and
+ * reported to the driver station, and the log is saved too.  Disabling the
+ * robot stops the tests without changing anything.
+ */
+namespace Characterization
+{
+	/**
+	 * Loads the drive gains file, must come after Mobility is initialized
+	 */
+	void initialize();
+	void process();
+
+	void start();
+	void stop();
+	bool isRunning();
+}
+
+#endif /* SRC_CHARACTERIZATION_H_ */
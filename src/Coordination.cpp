@@ -1,27 +1,53 @@
 #include <Coordination.hpp>
 #include <Robot.hpp>
+#include <Subsystems/Cameras.hpp>
 #include <Subsystems/HolderWheels.hpp>
 #include <Subsystems/Mobility.hpp>
+#include <Subsystems/Odometry.hpp>
 #include <Subsystems/ShooterPitch.hpp>
 #include <Subsystems/ShooterWheels.hpp>
+#include <Subsystems/ShotTable.hpp>
+#include <Utils.hpp>
+#include <math.h>
 
 namespace Coordination
 {
-	const float AUTONOMOUS_SHOOTER_WHEELS_RATE = ShooterWheels::getRPMPreset(ShooterWheels::getPresetCount() - 1);
 	const float SHOOT_SPEED_UP_TIME = 5.0;
+	
+	// the holder wheels take this long to push the ball into the shooter wheels,
+	// so the ball can go once the shooter wheels will be ready by then
+	const float BALL_FEED_TIME = 0.15; // seconds, TODO: measure
 	const float PUSH_BOULDER_TIMER = 2.0;
 	
+	const float AIM_TOLERANCE = 1.5; // degrees the robot may point away from the goal and still shoot
+	
+	// the shot only changes when the goal moves by more than this, so that noise
+	// in the camera doesn't keep restarting the shooter
+	const float PITCH_CHANGE_THRESHOLD = 1.0; // degrees
+	const float RATE_CHANGE_THRESHOLD = 100.0; // rpm
+	
 	State state = State::WAITING;
 	
 	Timer* shoot_timer;
 	float shooter_rate = 0.0;
 	bool shot_ball = false;
 	
+	double last_frame_timestamp = 0.0;
+	bool has_aim = false;
+	float aim_heading = 0.0;
+	float aim_pitch = 0.0;
+	float aim_rate = 0.0;
+	
 	void setState(State new_state);
+	void aim(bool spin_up);
+	bool isAimed();
+	bool isPitchReady();
+	bool areWheelsReady();
+	bool willWheelsBeReady();
 	
 	void initialize()
 	{
-		shoot_timer = new Timer();
+		shoot_timer = Utils::constructTimer();
 	}
 	
 	void process()
@@ -32,7 +58,7 @@ namespace Coordination
 			break;
 		
 		case State::SHOOTING_BALL:
-			if (ShooterWheels::atRate() || shoot_timer->Get() > SHOOT_SPEED_UP_TIME) {
+			if (willWheelsBeReady()) {
 				if (shot_ball && HolderWheels::getState() == HolderWheels::WAITING) {
 					setState(WAITING);
 				}
@@ -44,13 +70,83 @@ namespace Coordination
 			break;
 		
 		case State::AUTO_AIM:
+			aim(false);
 			break;
 		
 		case State::AUTO_SHOOT:
+			if (shot_ball) {
+				if (HolderWheels::getState() == HolderWheels::WAITING) {
+					setState(WAITING);
+				}
+				break;
+			}
+			
+			// turning, pitching and spinning up all happen at once, and the ball
+			// goes as soon as the slowest of them is ready
+			aim(true);
+			if (isAimed() && isPitchReady() && areWheelsReady()) {
+				HolderWheels::shootBall();
+				shot_ball = true;
+			}
 			break;
 		}
 	}
 	
+	void aim(bool spin_up)
+	{
+		if (!Cameras::canSeeGoal()) {
+			return;
+		}
+		
+		// only a new frame says anything new about where the goal is
+		double frame_timestamp = Cameras::getTargetTimestamp();
+		if (has_aim && frame_timestamp == last_frame_timestamp) {
+			return;
+		}
+		last_frame_timestamp = frame_timestamp;
+		
+		// the bearing is from where the robot was pointing when the frame was taken
+		aim_heading = Odometry::getPoseAt(frame_timestamp).heading + Cameras::getTargetBearing();
+		if (fabs(aim_heading - Odometry::getHeading()) > AIM_TOLERANCE) {
+			Mobility::turnToHeading(aim_heading);
+		}
+		
+		ShotTable::Shot shot = ShotTable::getShot(Cameras::getDistanceFromTarget());
+		if (!has_aim || fabs(shot.pitch - aim_pitch) > PITCH_CHANGE_THRESHOLD) {
+			aim_pitch = shot.pitch;
+			ShooterPitch::goToAngle(aim_pitch);
+		}
+		
+		if (spin_up && (!has_aim || fabs(shot.rate - aim_rate) > RATE_CHANGE_THRESHOLD)) {
+			aim_rate = shot.rate;
+			ShooterWheels::setRate(aim_rate);
+		}
+		
+		has_aim = true;
+	}
+	
+	bool isAimed()
+	{
+		return has_aim && fabs(aim_heading - Odometry::getHeading()) < AIM_TOLERANCE;
+	}
+	
+	bool isPitchReady()
+	{
+		return has_aim && ShooterPitch::atAngle();
+	}
+	
+	bool areWheelsReady()
+	{
+		return has_aim && willWheelsBeReady();
+	}
+	
+	bool willWheelsBeReady()
+	{
+		// without PID the wheels can't tell when they're at speed, so give them time
+		return ShooterWheels::atRate() || ShooterWheels::getTimeToReady() <= BALL_FEED_TIME ||
+			shoot_timer->Get() > SHOOT_SPEED_UP_TIME;
+	}
+	
 	void shootBall(float rate)
 	{
 		shooter_rate = rate;
@@ -93,6 +189,9 @@ namespace Coordination
 				break;
 			
 			case State::AUTO_AIM:
+				if (new_state == State::AUTO_SHOOT) {
+					break; // keep the aim, and shoot from it
+				}
 				Mobility::interrupt();
 				ShooterPitch::interrupt();
 				break;
@@ -126,9 +225,16 @@ namespace Coordination
 				break;
 			
 			case State::AUTO_AIM:
+				has_aim = false;
 				break;
 			
 			case State::AUTO_SHOOT:
+				// aim again so the wheels are told to spin, the turn and the pitch
+				// carry on from AUTO_AIM if they were already under way
+				has_aim = false;
+				shot_ball = false;
+				shoot_timer->Start();
+				shoot_timer->Reset();
 				break;
 			}
 			
@@ -23,13 +23,15 @@ namespace Coordination
 	/**
 	 * Uses the front camera to aim the robot at the goal.
 	 * Simultaneously turns left and right with mobility and lifts
-	 * the shooter up and down.
+	 * the shooter up and down, and keeps aiming until interrupted.
 	 */
 	void autoAim();
 
 	/**
-	 * Combines autoAim() and shootBall().  First aims the robot,
-	 * then shoots the ball.
+	 * Combines autoAim() and shootBall().  Aims the robot and spins up the
+	 * shooter wheels at the same time, and shoots the ball the moment the
+	 * robot is pointed at the goal, the shooter is at the right angle and the
+	 * wheels are at speed.
 	 */
 	void autoShoot();
 	void interrupt();
@@ -0,0 +1,104 @@
+#include <ED/BufferedMotor.hpp>
+#include <WPILib.h>
+
+namespace ED
+{
+	BufferedMotor::BufferedMotor(SpeedController* motor) :
+		motor(motor),
+		interlock(nullptr),
+		speed(0.0),
+		sync_group(0),
+		written_speed(0.0),
+		written(false),
+		held(false),
+		write_count(0)
+	{
+
+	}
+
+	BufferedMotor::~BufferedMotor()
+	{
+
+	}
+
+	void BufferedMotor::Set(float speed, uint8_t sync_group)
+	{
+		this->speed = speed;
+		this->sync_group = sync_group;
+	}
+
+	float BufferedMotor::Get() const
+	{
+		return speed;
+	}
+
+	void BufferedMotor::Disable()
+	{
+		motor->Disable();
+		speed = 0.0;
+		written = false;
+	}
+
+	void BufferedMotor::SetInverted(bool inverted)
+	{
+		motor->SetInverted(inverted);
+	}
+
+	bool BufferedMotor::GetInverted() const
+	{
+		return motor->GetInverted();
+	}
+
+	void BufferedMotor::PIDWrite(float output)
+	{
+		Set(output);
+	}
+
+	void BufferedMotor::setInterlock(Interlock interlock)
+	{
+		this->interlock = interlock;
+	}
+
+	bool BufferedMotor::flush()
+	{
+		if (held) {
+			return false;
+		}
+
+		float safe_speed = interlock != nullptr ? interlock(speed) : speed;
+		if (written && safe_speed == written_speed) {
+			return false;
+		}
+
+		motor->Set(safe_speed, sync_group);
+		written_speed = safe_speed;
+		written = true;
+		++write_count;
+		return true;
+	}
+
+	void BufferedMotor::invalidate()
+	{
+		written = false;
+	}
+
+	void BufferedMotor::hold(bool held)
+	{
+		this->held = held;
+	}
+
+	bool BufferedMotor::isHeld() const
+	{
+		return held;
+	}
+
+	SpeedController* BufferedMotor::getController() const
+	{
+		return motor;
+	}
+
+	uint32_t BufferedMotor::getWriteCount() const
+	{
+		return write_count;
+	}
+}
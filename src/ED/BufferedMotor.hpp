@@ -0,0 +1,97 @@
+#ifndef SRC_ED_BUFFEREDMOTOR_HPP_
+#define SRC_ED_BUFFEREDMOTOR_HPP_
+
+#include <stdint.h>
+#include <WPILib.h>
+
+namespace ED
+{
+/**
+ * Holds the speed set on a motor until it's flushed, and then only writes it
+ * to the motor if it changed.
+ *
+ * Subsystems set their motors many times a loop, and to the same speed loop
+ * after loop, and every one of those is a HAL call, or a message over CAN for
+ * a CANTalon.  With every motor buffered, the last speed set in a loop is the
+ * only one that counts, and flush writes it once at the end of the loop.
+ *
+ * An interlock can be given to veto speeds that aren't safe, like driving a
+ * mechanism into a limit switch.  It's applied once, when flushing, to the
+ * final speed of the loop.
+ *
+ * Disable goes straight to the motor, and isn't buffered.
+ *
+ * While a motor controller runs its own closed loop, whatever it's Set to is
+ * its setpoint, not a speed, so the motor is held and flush leaves it alone.
+ */
+class BufferedMotor : public SpeedController
+{
+public:
+	/**
+	 * returns the speed that is safe to write in place of the one set
+	 */
+	typedef float (*Interlock)(float speed);
+
+	/**
+	 * @param motor the motor to write to, which must outlive the BufferedMotor
+	 */
+	explicit BufferedMotor(SpeedController* motor);
+	virtual ~BufferedMotor();
+
+	/**
+	 * sets the speed to write at the next flush
+	 */
+	virtual void Set(float speed, uint8_t sync_group = 0);
+	/**
+	 * @return the speed last set, before the interlock
+	 */
+	virtual float Get() const;
+	virtual void Disable();
+	virtual void SetInverted(bool inverted);
+	virtual bool GetInverted() const;
+	virtual void PIDWrite(float output);
+
+	void setInterlock(Interlock interlock);
+
+	/**
+	 * writes the speed to the motor, through the interlock, if it's different
+	 * from the last one written
+	 * @return whether the motor was written to
+	 */
+	bool flush();
+	/**
+	 * forces the next flush to write, for when something else has written to
+	 * the motor directly
+	 */
+	void invalidate();
+
+	/**
+	 * stops or resumes flushing, for while something else owns the motor
+	 */
+	void hold(bool held);
+	bool isHeld() const;
+
+	SpeedController* getController() const;
+
+	/**
+	 * @return the number of times the motor has been written to
+	 */
+	uint32_t getWriteCount() const;
+
+private:
+	SpeedController* motor;
+	Interlock interlock;
+
+	float speed;
+	uint8_t sync_group;
+	float written_speed;
+	bool written;
+	bool held;
+	uint32_t write_count;
+
+	BufferedMotor(const BufferedMotor&) = delete;
+	BufferedMotor& operator=(const BufferedMotor&) = delete;
+};
+}
+
+#endif /* SRC_ED_BUFFEREDMOTOR_HPP_ */
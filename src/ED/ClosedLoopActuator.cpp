@@ -0,0 +1,118 @@
+#include <CANTalon.h>
+#include <ED/BufferedMotor.hpp>
+#include <ED/ClosedLoopActuator.hpp>
+#include <WPILib.h>
+
+namespace ED
+{
+	// the Talon's full output, and how often its loop runs
+	const double TALON_FULL_OUTPUT = 1023.0;
+	const double TALON_LOOP_PERIOD = 0.001; // seconds
+
+	ClosedLoopActuator::ClosedLoopActuator(SpeedController* motor, PIDManager* pid_manager, const Config& config) :
+		pid_manager(pid_manager),
+		buffered_motor(dynamic_cast<BufferedMotor*>(motor)),
+		talon(dynamic_cast<CANTalon*>(buffered_motor != nullptr ? buffered_motor->getController() : motor)),
+		config(config),
+		enabled(false),
+		sent_target(0.0),
+		sent_gains({ 0.0, 0.0, 0.0, 0.0 })
+	{
+		if (isOffloaded()) {
+			talon->SetFeedbackDevice((CANTalon::FeedbackDevice)config.feedback_device);
+			talon->SetSensorDirection(config.reverse_sensor);
+			talon->SelectProfileSlot(0);
+			talon->SetControlMode(CANTalon::kPercentVbus);
+		}
+		enable(pid_manager->isEnabled());
+	}
+
+	bool ClosedLoopActuator::isOffloaded() const
+	{
+		return talon != nullptr;
+	}
+
+	void ClosedLoopActuator::enable(bool enable)
+	{
+		if (!isOffloaded()) {
+			pid_manager->enable(enable);
+			enabled = enable;
+			return;
+		}
+
+		// the Talon runs the loop, so the PIDManager must never drive the motor too
+		pid_manager->enable(false);
+
+		if (enable && !enabled) {
+			holdBuffer(true);
+			pushGains({ pid_manager->getP(), pid_manager->getI(), pid_manager->getD(), pid_manager->getF() });
+			talon->SetControlMode(config.mode == Mode::VELOCITY ? CANTalon::kSpeed : CANTalon::kPosition);
+			sent_target = pid_manager->getTarget();
+			talon->Set(sent_target * config.native_per_unit + (config.mode == Mode::POSITION ? config.native_offset : 0.0));
+			talon->EnableControl();
+		}
+		else if (!enable && enabled) {
+			talon->SetControlMode(CANTalon::kPercentVbus);
+			talon->Set(0.0);
+			holdBuffer(false);
+		}
+		enabled = enable;
+	}
+
+	bool ClosedLoopActuator::isEnabled() const
+	{
+		return enabled;
+	}
+
+	void ClosedLoopActuator::process()
+	{
+		if (!isOffloaded()) {
+			pid_manager->process();
+			return;
+		}
+		if (!enabled) {
+			return;
+		}
+
+		// the gain schedule may have switched gains along with the target
+		PIDManager::Gains gains = { pid_manager->getP(), pid_manager->getI(), pid_manager->getD(), pid_manager->getF() };
+		if (gains.p != sent_gains.p || gains.i != sent_gains.i || gains.d != sent_gains.d || gains.f != sent_gains.f) {
+			pushGains(gains);
+		}
+
+		float target = pid_manager->getTarget();
+		if (target != sent_target) {
+			sent_target = target;
+			talon->Set(target * config.native_per_unit + (config.mode == Mode::POSITION ? config.native_offset : 0.0));
+		}
+	}
+
+	void ClosedLoopActuator::holdBuffer(bool held)
+	{
+		if (buffered_motor == nullptr) {
+			return;
+		}
+
+		// while the Talon runs its loop, anything the buffer wrote would be
+		// taken as its setpoint; once it's back in percent output it was left
+		// at 0.0 behind the buffer's back, so the buffer starts over from there
+		if (!held) {
+			buffered_motor->Set(0.0);
+			buffered_motor->invalidate();
+		}
+		buffered_motor->hold(held);
+	}
+
+	void ClosedLoopActuator::pushGains(const PIDManager::Gains& gains)
+	{
+		sent_gains = gains;
+
+		// the PIDManager's gains are in output (-1.0 to 1.0) per unit of error,
+		// integrated over seconds and differentiated per second, while the
+		// Talon's are in output (-1023 to 1023) per native unit, summed or
+		// differenced once per millisecond
+		double scale = TALON_FULL_OUTPUT / config.native_per_unit;
+		double f = config.mode == Mode::VELOCITY ? gains.f * scale : 0.0;
+		talon->SetPID(gains.p * scale, gains.i * scale * TALON_LOOP_PERIOD, gains.d * scale / TALON_LOOP_PERIOD, f);
+	}
+}
@@ -0,0 +1,100 @@
+#ifndef SRC_ED_CLOSEDLOOPACTUATOR_HPP_
+#define SRC_ED_CLOSEDLOOPACTUATOR_HPP_
+
+#include <ED/PIDManager.hpp>
+
+class CANTalon;
+class SpeedController;
+
+namespace ED
+{
+class BufferedMotor;
+
+/**
+ * Runs a closed loop either on the roboRIO with a PIDManager, or on the motor
+ * controller itself when it's a CANTalon.
+ *
+ * A CANTalon can run its own position or velocity loop at 1 kHz from a sensor
+ * wired to it, which is far faster than the roboRIO loop and costs the roboRIO
+ * nothing.  The PIDManager stays the one place the gains and target are set:
+ * when the loop is offloaded, the PIDManager is kept disabled, and process
+ * pushes its target and gains (including any from its gain schedule) down to
+ * the Talon whenever they change, converted into the Talon's units.
+ *
+ * The Talon's feed-forward multiplies the setpoint, so only a feed-forward of
+ * the form F * target carries over.  In velocity mode F is converted like the
+ * other gains, but in position mode it's left out, so a gravity feed-forward
+ * on an arm falls to the Talon's integral term.
+ *
+ * Any other SpeedController falls back to the PIDManager, unchanged.  A
+ * BufferedMotor is looked through to the motor it buffers, and held while the
+ * Talon runs its loop so the buffer never overwrites the setpoint.
+ */
+class ClosedLoopActuator
+{
+public:
+	enum Mode {
+		POSITION,
+		VELOCITY
+	};
+
+	struct Config {
+		Mode mode;
+		int feedback_device; // a CANTalon::FeedbackDevice
+		bool reverse_sensor;
+		/*
+		 * Talon sensor units per unit of the PIDManager's target.  Positions are
+		 * counted in native units (4 per encoder code, or 1024 across a
+		 * potentiometer's turns), and velocities in native units per 100 ms,
+		 * so an encoder with 360 codes per revolution is 1440 / 360 per degree,
+		 * or 1440 / 600 per rpm.
+		 */
+		float native_per_unit;
+		float native_offset; // the sensor reading at a target of 0.0, for positions
+	};
+
+	/**
+	 * @param motor       the motor the PIDManager drives
+	 * @param pid_manager the PIDManager holding the gains and target
+	 * @param config      how the sensor wired to the Talon reads, unused when
+	 *                    the motor isn't a CANTalon
+	 */
+	ClosedLoopActuator(SpeedController* motor, PIDManager* pid_manager, const Config& config);
+
+	/**
+	 * @return whether the loop runs on a CANTalon rather than the PIDManager
+	 */
+	bool isOffloaded() const;
+
+	/**
+	 * starts or stops the loop, wherever it runs.  A stopped Talon goes back to
+	 * percent output, so the motor can be set directly.
+	 */
+	void enable(bool enable);
+	bool isEnabled() const;
+
+	/**
+	 * runs the PIDManager, or sends its target and gains to the Talon if they
+	 * changed since the last call
+	 */
+	void process();
+
+private:
+	void pushGains(const PIDManager::Gains& gains);
+	void holdBuffer(bool held);
+
+	PIDManager* pid_manager;
+	BufferedMotor* buffered_motor;
+	CANTalon* talon;
+	Config config;
+
+	bool enabled;
+	float sent_target;
+	PIDManager::Gains sent_gains;
+
+	ClosedLoopActuator(const ClosedLoopActuator&) = delete;
+	ClosedLoopActuator& operator=(const ClosedLoopActuator&) = delete;
+};
+}
+
+#endif /* SRC_ED_CLOSEDLOOPACTUATOR_HPP_ */
@@ -0,0 +1,150 @@
+#include <ED/DriveCharacterizer.hpp>
+#include <stdio.h>
+
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+namespace ED
+{
+	// samples slower than this are left out, since friction is neither one
+	// way nor the other while stopped
+	const float MIN_RATE = 2.0; // cm/s
+	const float MIN_TURN_RATE = 10.0; // degrees per second
+	// neighbours further apart than this are from different tests
+	const float MAX_SAMPLE_GAP = 0.05; // seconds
+	const int MIN_FIT_SAMPLES = 20;
+
+	DriveCharacterizer::DriveCharacterizer() :
+		count(0)
+	{
+
+	}
+
+	void DriveCharacterizer::clear()
+	{
+		count = 0;
+	}
+
+	bool DriveCharacterizer::record(const Sample& sample)
+	{
+		if (count >= MAX_SAMPLES) {
+			return false;
+		}
+		samples[count++] = sample;
+		return true;
+	}
+
+	int DriveCharacterizer::getCount() const
+	{
+		return count;
+	}
+
+	bool DriveCharacterizer::fit(Gains& gains) const
+	{
+		// the normal equations of the least squares fit, X'X b = X'y, with the
+		// columns of X being sign(velocity), velocity and acceleration
+		double xx[3][3] = { { 0.0 } };
+		double xy[3] = { 0.0 };
+		int fit_count = 0;
+
+		double turn_sum = 0.0;
+		double turn_squares = 0.0;
+
+		for (int i = 1; i + 1 < count; ++i) {
+			const Sample& before = samples[i - 1];
+			const Sample& sample = samples[i];
+			const Sample& after = samples[i + 1];
+
+			if (sample.turning) {
+				if (fabs(sample.turn_rate) > MIN_TURN_RATE) {
+					// turning clockwise speeds up the left side
+					double turn_rate = sample.turn_rate * M_PI / 180.0;
+					turn_sum += (sample.left_rate - sample.right_rate) * turn_rate;
+					turn_squares += turn_rate * turn_rate;
+				}
+				continue;
+			}
+
+			double interval = after.time - before.time;
+			if (before.turning || after.turning || interval <= 0.0 || interval > 2.0 * MAX_SAMPLE_GAP) {
+				continue;
+			}
+
+			// both sides fit the same model
+			const float rates[2][3] = {
+				{ before.left_rate, sample.left_rate, after.left_rate },
+				{ before.right_rate, sample.right_rate, after.right_rate }
+			};
+			const float outputs[2] = { sample.left_output, sample.right_output };
+			for (int side = 0; side < 2; ++side) {
+				double rate = rates[side][1];
+				if (fabs(rate) < MIN_RATE) {
+					continue;
+				}
+				double x[3] = { rate > 0.0 ? 1.0 : -1.0, rate, (rates[side][2] - rates[side][0]) / interval };
+				for (int r = 0; r < 3; ++r) {
+					for (int c = 0; c < 3; ++c) {
+						xx[r][c] += x[r] * x[c];
+					}
+					xy[r] += x[r] * outputs[side];
+				}
+				++fit_count;
+			}
+		}
+
+		if (turn_squares > 0.0) {
+			gains.wheelbase = turn_sum / turn_squares;
+		}
+
+		if (fit_count < MIN_FIT_SAMPLES) {
+			return false;
+		}
+
+		// Cramer's rule, which is plenty for three unknowns
+		double determinant =
+			xx[0][0] * (xx[1][1] * xx[2][2] - xx[1][2] * xx[2][1]) -
+			xx[0][1] * (xx[1][0] * xx[2][2] - xx[1][2] * xx[2][0]) +
+			xx[0][2] * (xx[1][0] * xx[2][1] - xx[1][1] * xx[2][0]);
+		if (fabs(determinant) < 1e-9 * xx[0][0] * xx[1][1] * xx[2][2]) {
+			return false; // the samples can't tell the gains apart
+		}
+
+		double solution[3];
+		for (int k = 0; k < 3; ++k) {
+			// replace column k with X'y
+			double m[3][3];
+			for (int r = 0; r < 3; ++r) {
+				for (int c = 0; c < 3; ++c) {
+					m[r][c] = c == k ? xy[r] : xx[r][c];
+				}
+			}
+			solution[k] = (
+				m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+				m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+				m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0])) / determinant;
+		}
+		gains.ks = solution[0];
+		gains.kv = solution[1];
+		gains.ka = solution[2];
+		return true;
+	}
+
+	bool DriveCharacterizer::write(const char* path) const
+	{
+		FILE* file = fopen(path, "w");
+		if (file == nullptr) {
+			return false;
+		}
+
+		bool ok = fprintf(file, "time,left_output,right_output,left_distance,right_distance,left_rate,right_rate,turn_rate,turning\n") > 0;
+		for (int i = 0; i < count && ok; ++i) {
+			const Sample& sample = samples[i];
+			ok = fprintf(file, "%.4f,%.4f,%.4f,%.2f,%.2f,%.2f,%.2f,%.2f,%d\n",
+				sample.time, sample.left_output, sample.right_output, sample.left_distance, sample.right_distance,
+				sample.left_rate, sample.right_rate, sample.turn_rate, sample.turning) > 0;
+		}
+
+		return fclose(file) == 0 && ok;
+	}
+}
@@ -0,0 +1,81 @@
+#ifndef SRC_ED_DRIVECHARACTERIZER_HPP_
+#define SRC_ED_DRIVECHARACTERIZER_HPP_
+
+namespace ED
+{
+/**
+ * Fits the feedforward model of a tank drive train to samples logged while
+ * driving it, so that its gains come from data instead of guesses.
+ *
+ * Each side of the drive train is modeled as
+ *   output = ks * sign(velocity) + kv * velocity + ka * acceleration
+ * which a least squares fit over the samples logged while driving straight
+ * gives all three gains of, once they cover both slow ramps, where
+ * acceleration is negligible, and sudden steps, where it isn't.  The
+ * acceleration is the difference between the rates of neighbouring samples.
+ *
+ * The effective wheelbase comes from the samples logged while turning in
+ * place, as the difference between the speeds of the sides over the turn
+ * rate measured by the gyro.
+ *
+ * The samples go into a buffer allocated with the characterizer, so logging
+ * them never allocates.
+ */
+class DriveCharacterizer
+{
+public:
+	static const int MAX_SAMPLES = 8192;
+
+	struct Sample {
+		float time; // seconds
+		float left_output; // as actually applied to the motors
+		float right_output;
+		float left_distance; // cm
+		float right_distance;
+		float left_rate; // cm/s
+		float right_rate;
+		float turn_rate; // degrees per second, clockwise
+		bool turning; // whether the sides are driven against each other
+	};
+
+	struct Gains {
+		float ks; // output needed to overcome friction
+		float kv; // output per cm/s
+		float ka; // output per cm/s^2
+		float wheelbase; // cm
+	};
+
+	DriveCharacterizer();
+
+	void clear();
+	/**
+	 * @return false if the buffer is full, and the sample wasn't kept
+	 */
+	bool record(const Sample& sample);
+	int getCount() const;
+
+	/**
+	 * @param  gains set to the gains found; the wheelbase is only set if
+	 *         there are samples from turning
+	 * @return false if the samples don't pin the drive gains down, like when
+	 *         there are none with the robot accelerating
+	 */
+	bool fit(Gains& gains) const;
+
+	/**
+	 * writes every sample, one per line, separated by commas, for checking
+	 * the fit offline
+	 * @return whether the whole file was written
+	 */
+	bool write(const char* path) const;
+
+private:
+	Sample samples[MAX_SAMPLES];
+	int count;
+
+	DriveCharacterizer(const DriveCharacterizer&) = delete;
+	DriveCharacterizer& operator=(const DriveCharacterizer&) = delete;
+};
+}
+
+#endif /* SRC_ED_DRIVECHARACTERIZER_HPP_ */
@@ -0,0 +1,256 @@
+#include <ED/DriveController.hpp>
+
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+namespace ED
+{
+	const float DEGREES_TO_RADIANS = M_PI / 180.0;
+
+	const int MAX_RICCATI_ITERATIONS = 5000;
+	const float RICCATI_TOLERANCE = 1e-5; // relative change at which the iteration has converged
+
+	// a longer gap than this between loops means the robot was disabled, and
+	// the estimate starts over from the measurements
+	const float MAX_PREDICTION = 0.1; // seconds
+
+	DriveController::DriveController(const Config& config, const Model& model) :
+		config(config),
+		model(model),
+		gain(),
+		state(),
+		covariance()
+	{
+		setModel(model);
+		reset(0.0, 0.0, 0.0);
+	}
+
+	bool DriveController::setModel(const Model& model)
+	{
+		if (model.kv <= 0.0 || model.ka <= 0.0 || model.wheelbase <= 0.0) {
+			return false;
+		}
+		Model last_model = this->model;
+		this->model = model;
+
+		Matrix<STATES, STATES> a;
+		Matrix<STATES, INPUTS> b;
+		discretize(config.period, a, b);
+
+		// Bryson's rule: each state and output costs one at its largest allowed value
+		Matrix<STATES, STATES> q;
+		q(LEFT_SPEED, LEFT_SPEED) = 1.0 / (config.max_speed_error * config.max_speed_error);
+		q(RIGHT_SPEED, RIGHT_SPEED) = q(LEFT_SPEED, LEFT_SPEED);
+		float max_heading_error = config.max_heading_error * DEGREES_TO_RADIANS;
+		q(HEADING, HEADING) = 1.0 / (max_heading_error * max_heading_error);
+		Matrix<INPUTS, INPUTS> r;
+		r(0, 0) = 1.0 / (config.max_output * config.max_output);
+		r(1, 1) = r(0, 0);
+
+		// iterate the discrete Riccati equation to its fixed point
+		Matrix<STATES, STATES> p = q;
+		Matrix<INPUTS, STATES> k;
+		Matrix<INPUTS, STATES> b_transpose_p;
+		bool converged = false;
+		for (int iteration = 0; iteration < MAX_RICCATI_ITERATIONS && !converged; ++iteration) {
+			b_transpose_p = b.transpose() * p;
+			Matrix<INPUTS, INPUTS> s = r + b_transpose_p * b;
+
+			// s is only 2x2, so it's inverted directly
+			float determinant = s(0, 0) * s(1, 1) - s(0, 1) * s(1, 0);
+			if (determinant == 0.0) {
+				break;
+			}
+			Matrix<INPUTS, INPUTS> s_inverse;
+			s_inverse(0, 0) = s(1, 1) / determinant;
+			s_inverse(0, 1) = -s(0, 1) / determinant;
+			s_inverse(1, 0) = -s(1, 0) / determinant;
+			s_inverse(1, 1) = s(0, 0) / determinant;
+			k = s_inverse * (b_transpose_p * a);
+
+			Matrix<STATES, STATES> next_p = q + a.transpose() * p * (a - b * k);
+
+			float largest = 0.0;
+			float largest_change = 0.0;
+			for (int row = 0; row < STATES; ++row) {
+				for (int col = 0; col < STATES; ++col) {
+					// keep it symmetric against rounding
+					float value = (next_p(row, col) + next_p(col, row)) / 2.0;
+					largest = fmax(largest, fabs(value));
+					largest_change = fmax(largest_change, fabs(value - p(row, col)));
+					next_p(row, col) = value;
+				}
+			}
+			p = next_p;
+			converged = largest_change <= RICCATI_TOLERANCE * largest;
+		}
+
+		if (!converged) {
+			this->model = last_model;
+			return false;
+		}
+		gain = k;
+		return true;
+	}
+
+	void DriveController::reset(float left_speed, float right_speed, float heading)
+	{
+		state(LEFT_SPEED, 0) = left_speed;
+		state(RIGHT_SPEED, 0) = right_speed;
+		state(HEADING, 0) = heading * DEGREES_TO_RADIANS;
+
+		covariance.fill(0.0);
+		covariance(LEFT_SPEED, LEFT_SPEED) = config.encoder_speed_noise * config.encoder_speed_noise;
+		covariance(RIGHT_SPEED, RIGHT_SPEED) = covariance(LEFT_SPEED, LEFT_SPEED);
+		float heading_noise = config.gyro_angle_noise * DEGREES_TO_RADIANS;
+		covariance(HEADING, HEADING) = heading_noise * heading_noise;
+	}
+
+	void DriveController::update(float dt, float left_output, float right_output, const Measurement& measurement)
+	{
+		if (dt <= 0.0) {
+			return;
+		}
+		if (dt > MAX_PREDICTION) {
+			reset(measurement.has_speeds ? measurement.left_speed : 0.0,
+				measurement.has_speeds ? measurement.right_speed : 0.0,
+				measurement.has_gyro ? measurement.heading : getHeading());
+			return;
+		}
+
+		// the model is linear past friction, which opposes the way each side is moving
+		float left_speed = state(LEFT_SPEED, 0);
+		float right_speed = state(RIGHT_SPEED, 0);
+		Vector<INPUTS> input;
+		input(0, 0) = left_output - (left_speed > 0.0 ? model.ks : (left_speed < 0.0 ? -model.ks : 0.0));
+		input(1, 0) = right_output - (right_speed > 0.0 ? model.ks : (right_speed < 0.0 ? -model.ks : 0.0));
+
+		Matrix<STATES, STATES> a;
+		Matrix<STATES, INPUTS> b;
+		discretize(dt, a, b);
+		state = a * state + b * input;
+		covariance = a * covariance * a.transpose();
+		covariance(LEFT_SPEED, LEFT_SPEED) += config.speed_noise * dt;
+		covariance(RIGHT_SPEED, RIGHT_SPEED) += config.speed_noise * dt;
+		covariance(HEADING, HEADING) += config.heading_noise * DEGREES_TO_RADIANS * DEGREES_TO_RADIANS * dt;
+
+		Matrix<1, STATES> row;
+		if (measurement.has_speeds) {
+			row.fill(0.0);
+			row(0, LEFT_SPEED) = 1.0;
+			correct(row, measurement.left_speed, config.encoder_speed_noise);
+
+			row.fill(0.0);
+			row(0, RIGHT_SPEED) = 1.0;
+			correct(row, measurement.right_speed, config.encoder_speed_noise);
+		}
+		if (measurement.has_gyro) {
+			// turning clockwise speeds up the left side
+			row.fill(0.0);
+			row(0, LEFT_SPEED) = 1.0 / model.wheelbase;
+			row(0, RIGHT_SPEED) = -1.0 / model.wheelbase;
+			correct(row, measurement.turn_rate * DEGREES_TO_RADIANS, config.gyro_rate_noise * DEGREES_TO_RADIANS);
+
+			row.fill(0.0);
+			row(0, HEADING) = 1.0;
+			correct(row, measurement.heading * DEGREES_TO_RADIANS, config.gyro_angle_noise * DEGREES_TO_RADIANS);
+		}
+	}
+
+	void DriveController::calculate(float left_speed, float right_speed, float left_acceleration, float right_acceleration,
+		float heading, float& left_output, float& right_output) const
+	{
+		Vector<STATES> error;
+		error(LEFT_SPEED, 0) = left_speed - state(LEFT_SPEED, 0);
+		error(RIGHT_SPEED, 0) = right_speed - state(RIGHT_SPEED, 0);
+		error(HEADING, 0) = heading * DEGREES_TO_RADIANS - state(HEADING, 0);
+		Vector<INPUTS> feedback = gain * error;
+
+		left_output = model.kv * left_speed + model.ka * left_acceleration + feedback(0, 0);
+		right_output = model.kv * right_speed + model.ka * right_acceleration + feedback(1, 0);
+		if (left_speed > 0.0) {
+			left_output += model.ks;
+		}
+		else if (left_speed < 0.0) {
+			left_output -= model.ks;
+		}
+		if (right_speed > 0.0) {
+			right_output += model.ks;
+		}
+		else if (right_speed < 0.0) {
+			right_output -= model.ks;
+		}
+
+		left_output = left_output > 1.0 ? 1.0 : (left_output < -1.0 ? -1.0 : left_output);
+		right_output = right_output > 1.0 ? 1.0 : (right_output < -1.0 ? -1.0 : right_output);
+	}
+
+	float DriveController::getLeftSpeed() const
+	{
+		return state(LEFT_SPEED, 0);
+	}
+
+	float DriveController::getRightSpeed() const
+	{
+		return state(RIGHT_SPEED, 0);
+	}
+
+	float DriveController::getHeading() const
+	{
+		return state(HEADING, 0) / DEGREES_TO_RADIANS;
+	}
+
+	const Matrix<DriveController::INPUTS, DriveController::STATES>& DriveController::getGain() const
+	{
+		return gain;
+	}
+
+	void DriveController::discretize(float dt, Matrix<STATES, STATES>& a, Matrix<STATES, INPUTS>& b) const
+	{
+		// each side decays towards the speed its output holds, output / kv,
+		// with the time constant ka / kv
+		float rate = model.kv / model.ka;
+		float decay = exp(-rate * dt);
+		float step = (1.0 - decay) / rate; // the integral of the decay over dt
+		float distance_per_output = (dt - step) / model.ka / rate; // how far a constant output moves a side from rest
+
+		a.fill(0.0);
+		a(LEFT_SPEED, LEFT_SPEED) = decay;
+		a(RIGHT_SPEED, RIGHT_SPEED) = decay;
+		a(HEADING, LEFT_SPEED) = step / model.wheelbase;
+		a(HEADING, RIGHT_SPEED) = -step / model.wheelbase;
+		a(HEADING, HEADING) = 1.0;
+
+		b.fill(0.0);
+		b(LEFT_SPEED, 0) = step / model.ka;
+		b(RIGHT_SPEED, 1) = step / model.ka;
+		b(HEADING, 0) = distance_per_output / model.wheelbase;
+		b(HEADING, 1) = -distance_per_output / model.wheelbase;
+	}
+
+	void DriveController::correct(const Matrix<1, STATES>& row, float value, float noise)
+	{
+		float innovation = value - (row * state)(0, 0);
+
+		// P * H^T is a column, so compute it once and reuse it for the gain
+		Vector<STATES> covariance_row = covariance * row.transpose();
+		float innovation_variance = noise * noise + (row * covariance_row)(0, 0);
+		if (innovation_variance <= 0.0) {
+			return;
+		}
+
+		for (int r = 0; r < STATES; ++r) {
+			state(r, 0) += covariance_row(r, 0) / innovation_variance * innovation;
+		}
+
+		// P = P - K * H * P, where H * P is the transpose of P * H^T because P is symmetric
+		for (int r = 0; r < STATES; ++r) {
+			for (int c = 0; c <= r; ++c) {
+				float updated = covariance(r, c) - covariance_row(r, 0) * covariance_row(c, 0) / innovation_variance;
+				covariance(r, c) = updated;
+				covariance(c, r) = updated;
+			}
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#ifndef SRC_ED_DRIVECONTROLLER_HPP_
+#define SRC_ED_DRIVECONTROLLER_HPP_
+
+#include <ED/DriveCharacterizer.hpp>
+#include <ED/Matrix.hpp>
+
+namespace ED
+{
+/**
+ * A state-space controller for the speed of each side of a tank drive train
+ * and the heading of the robot, with a Kalman filter to estimate them.
+ *
+ * The state is the speed of the left and right sides and the heading.  Past
+ * friction, each side follows the model fit by DriveCharacterizer,
+ *   ka * acceleration = output - ks * sign(speed) - kv * speed
+ * and the heading turns at the difference of the sides over the effective
+ * wheelbase, clockwise when the left side is faster.
+ *
+ * The feedback gain is the linear quadratic regulator for that model,
+ * weighted by how much error in each state is too much and how much output
+ * there is to spend (Bryson's rule).  It's found by iterating the Riccati
+ * equation whenever the model changes, never in the loop.  It's computed for
+ * a short period, where it's nearly the continuous time gain, so that it
+ * suits a loop of any rate faster than that.
+ *
+ * Each loop, the filter predicts the state from the outputs that were last
+ * applied, and then corrects it with the encoder speeds and the gyro's turn
+ * rate and angle, one at a time, so no matrix is ever inverted.
+ *
+ * Units follow the rest of the code: centimeters, seconds and degrees.  All
+ * storage is inside the object and nothing allocates.
+ */
+class DriveController
+{
+public:
+	static const int STATES = 3;
+	static const int INPUTS = 2;
+
+	typedef DriveCharacterizer::Gains Model;
+
+	struct Config {
+		// the errors that call for full output, by Bryson's rule
+		float max_speed_error; // cm/s
+		float max_heading_error; // degrees
+		float max_output; // of the feedback, on top of the feedforward
+
+		float period; // the seconds the gain is computed for
+
+		// process noise, as variance gained per second
+		float speed_noise; // (cm/s)^2
+		float heading_noise; // degrees^2
+
+		// measurement noise, as standard deviations
+		float encoder_speed_noise; // cm/s
+		float gyro_rate_noise; // degrees per second
+		float gyro_angle_noise; // degrees
+	};
+
+	struct Measurement {
+		float left_speed;
+		float right_speed;
+		bool has_speeds;
+
+		float turn_rate;
+		float heading;
+		bool has_gyro;
+	};
+
+	DriveController(const Config& config, const Model& model);
+
+	/**
+	 * Switches to a new model, and computes the gain for it
+	 * @return false if the gain didn't converge, in which case the last one
+	 *         is kept
+	 */
+	bool setModel(const Model& model);
+
+	/**
+	 * Restarts the estimate at the measured state
+	 */
+	void reset(float left_speed, float right_speed, float heading);
+
+	/**
+	 * Predicts the state over dt from the outputs applied since the last
+	 * loop, and corrects it with what's measured
+	 */
+	void update(float dt, float left_output, float right_output, const Measurement& measurement);
+
+	/**
+	 * Calculates the outputs that drive each side at a speed while holding a
+	 * heading, from the feedforward of the model plus the feedback on the
+	 * estimated state
+	 * @param left_acceleration  of the left side, for the feedforward
+	 * @param right_acceleration of the right side
+	 */
+	void calculate(float left_speed, float right_speed, float left_acceleration, float right_acceleration,
+		float heading, float& left_output, float& right_output) const;
+
+	float getLeftSpeed() const;
+	float getRightSpeed() const;
+	float getHeading() const;
+
+	/**
+	 * @return the feedback gain, with the outputs as rows and the states as
+	 *         columns
+	 */
+	const Matrix<INPUTS, STATES>& getGain() const;
+
+private:
+	enum StateIndex {
+		LEFT_SPEED,
+		RIGHT_SPEED,
+		HEADING // radians
+	};
+
+	/**
+	 * the exact discrete model of the linear part over dt, for a constant output
+	 */
+	void discretize(float dt, Matrix<STATES, STATES>& a, Matrix<STATES, INPUTS>& b) const;
+	void correct(const Matrix<1, STATES>& row, float value, float noise);
+
+	Config config;
+	Model model;
+	Matrix<INPUTS, STATES> gain;
+
+	Vector<STATES> state;
+	Matrix<STATES, STATES> covariance;
+};
+}
+
+#endif /* SRC_ED_DRIVECONTROLLER_HPP_ */
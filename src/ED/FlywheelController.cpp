@@ -0,0 +1,150 @@
+#include <ED/FlywheelController.hpp>
+#include <limits>
+#include <math.h>
+
+namespace ED
+{
+	FlywheelController::FlywheelController(const Model& model, const Config& config) :
+		model(model),
+		config(config),
+		target(0.0),
+		estimate(0.0),
+		variance(0.0),
+		last_volts(0.0),
+		recovery_timer(0.0),
+		ready_timer(0.0)
+	{
+
+	}
+
+	void FlywheelController::setModel(const Model& model)
+	{
+		this->model = model;
+	}
+
+	const FlywheelController::Model& FlywheelController::getModel() const
+	{
+		return model;
+	}
+
+	void FlywheelController::setTarget(float target)
+	{
+		if (target != this->target) {
+			this->target = target;
+			ready_timer = 0.0;
+			recovery_timer = 0.0;
+		}
+	}
+
+	float FlywheelController::getTarget() const
+	{
+		return target;
+	}
+
+	void FlywheelController::reset(float measured_rate)
+	{
+		estimate = measured_rate;
+		variance = config.measurement_noise;
+		last_volts = 0.0;
+		recovery_timer = 0.0;
+		ready_timer = 0.0;
+	}
+
+	float FlywheelController::update(float measured_rate, bool new_measurement, float battery_voltage, float period)
+	{
+		// predict the rate from the volts applied over the last period, with
+		// friction only ever slowing the wheel down
+		float friction = model.kS;
+		if (estimate <= 0.0 && last_volts < model.kS) {
+			friction = last_volts;
+		}
+		estimate += (last_volts - friction - model.kV * estimate) / model.kA * period;
+		if (estimate < 0.0) {
+			estimate = 0.0;
+		}
+		variance += config.process_noise * period;
+
+		if (new_measurement) {
+			float innovation = measured_rate - estimate;
+			if (target > 0.0 && innovation < -config.shot_drop && recovery_timer <= 0.0) {
+				recovery_timer = config.recovery_time;
+			}
+
+			float gain = variance / (variance + config.measurement_noise);
+			estimate += gain * innovation;
+			variance *= 1.0 - gain;
+		}
+
+		float volts = 0.0;
+		if (target > 0.0) {
+			if (recovery_timer > 0.0) {
+				recovery_timer -= period;
+				if (estimate >= target - config.tolerance) {
+					recovery_timer = 0.0;
+				}
+			}
+
+			if (recovery_timer > 0.0) {
+				volts = battery_voltage;
+			}
+			else {
+				volts = model.kS + model.kV * target + config.kP * (target - estimate);
+			}
+
+			if (volts > battery_voltage) {
+				volts = battery_voltage;
+			}
+			if (volts < 0.0) {
+				volts = 0.0;
+			}
+		}
+		else {
+			recovery_timer = 0.0;
+		}
+
+		if (target > 0.0 && recovery_timer <= 0.0 && fabs(estimate - target) < config.tolerance) {
+			ready_timer += period;
+		}
+		else {
+			ready_timer = 0.0;
+		}
+
+		last_volts = volts;
+		return battery_voltage > 0.0 ? volts / battery_voltage : 0.0;
+	}
+
+	float FlywheelController::getEstimate() const
+	{
+		return estimate;
+	}
+
+	bool FlywheelController::isRecovering() const
+	{
+		return recovery_timer > 0.0;
+	}
+
+	bool FlywheelController::isReady() const
+	{
+		return target > 0.0 && ready_timer >= config.ready_time;
+	}
+
+	float FlywheelController::getTimeToReady(float battery_voltage) const
+	{
+		if (target <= 0.0 || isReady()) {
+			return 0.0;
+		}
+
+		float lowest_ready = target - config.tolerance;
+		if (estimate >= lowest_ready) {
+			return config.ready_time - ready_timer;
+		}
+
+		// at full voltage the rate rises exponentially toward the top speed
+		float top_speed = (battery_voltage - model.kS) / model.kV;
+		if (top_speed <= lowest_ready) {
+			return std::numeric_limits<float>::infinity();
+		}
+		float time_constant = model.kA / model.kV;
+		return time_constant * log((top_speed - estimate) / (top_speed - lowest_ready)) + config.ready_time;
+	}
+}
@@ -0,0 +1,112 @@
+#ifndef SRC_ED_FLYWHEELCONTROLLER_HPP_
+#define SRC_ED_FLYWHEELCONTROLLER_HPP_
+
+namespace ED
+{
+/**
+ * Holds a flywheel at a rate using a model of how it responds to voltage,
+ * rather than waiting for a PID loop to find the output.
+ *
+ * The model is the usual one for a motor spinning a load:
+ *
+ *   volts = kS + kV * rate + kA * acceleration
+ *
+ * The feedforward gives the volts to hold the target rate, and a small
+ * proportional term corrects what the model gets wrong.  Both are in volts
+ * and divided by the battery voltage, so the wheel behaves the same as the
+ * battery sags.
+ *
+ * The rate used for the proportional term comes from a Kalman filter, which
+ * predicts the rate from the volts applied and corrects the prediction with
+ * each measurement.  Between tachometer pulses the prediction keeps the
+ * estimate current, and when a measurement comes in far below the prediction,
+ * a ball has just gone through.  The controller then applies full voltage
+ * until the wheel is back up to speed (or recovery_time passes), instead of
+ * waiting for the error to build.
+ *
+ * Rates are in rpm and accelerations in rpm per second.
+ */
+class FlywheelController
+{
+public:
+	struct Model {
+		float kS; // volts to start the wheel moving
+		float kV; // volts per rpm
+		float kA; // volts per rpm per second
+	};
+
+	struct Config {
+		float kP; // volts per rpm of error
+		float process_noise; // rpm squared per second the model is expected to drift by
+		float measurement_noise; // rpm squared of noise in each measurement
+		float shot_drop; // rpm below the prediction a measurement must be to count as a shot
+		float recovery_time; // seconds of full voltage at most after a shot
+		float tolerance; // rpm from the target the wheel must be within to be ready
+		float ready_time; // seconds the wheel must stay within tolerance to be ready
+	};
+
+	FlywheelController(const Model& model, const Config& config);
+
+	void setModel(const Model& model);
+	const Model& getModel() const;
+
+	/**
+	 * Starts holding a new target rate; 0.0 lets the wheel coast
+	 */
+	void setTarget(float target);
+	float getTarget() const;
+
+	/**
+	 * Clears the estimate, for when the wheel has been driven by something else
+	 */
+	void reset(float measured_rate);
+
+	/**
+	 * Advances the controller one period
+	 * @param measured_rate   the latest measured rate
+	 * @param new_measurement whether measured_rate has changed since the last
+	 *                        call, so an old measurement isn't counted twice
+	 * @param battery_voltage the voltage the output will be a fraction of
+	 * @param period          seconds since the last call
+	 * @return the motor output, from 0.0 to 1.0
+	 */
+	float update(float measured_rate, bool new_measurement, float battery_voltage, float period);
+
+	/**
+	 * @return the estimated rate of the wheel
+	 */
+	float getEstimate() const;
+
+	/**
+	 * @return whether the wheel is recovering from a shot
+	 */
+	bool isRecovering() const;
+
+	/**
+	 * @return whether the wheel has been within tolerance for ready_time
+	 */
+	bool isReady() const;
+
+	/**
+	 * Estimates how long the wheel will take to be ready, going by the model
+	 * at full voltage
+	 * @return seconds, 0.0 when it's ready already, or infinity when the
+	 *         battery can't reach the target
+	 */
+	float getTimeToReady(float battery_voltage) const;
+
+private:
+	Model model;
+	const Config config;
+
+	float target;
+	float estimate;
+	float variance;
+	float last_volts;
+
+	float recovery_timer;
+	float ready_timer;
+};
+}
+
+#endif /* SRC_ED_FLYWHEELCONTROLLER_HPP_ */
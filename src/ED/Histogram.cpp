@@ -0,0 +1,88 @@
+#include <ED/Histogram.hpp>
+
+namespace ED
+{
+	Histogram::Histogram()
+	{
+		clear();
+	}
+
+	void Histogram::record(uint32_t value)
+	{
+		++counts[getBucket(value)];
+		++count;
+		if (value > max) {
+			max = value;
+		}
+	}
+
+	void Histogram::clear()
+	{
+		for (int i = 0; i < BUCKETS; ++i) {
+			counts[i] = 0;
+		}
+		count = 0;
+		max = 0;
+	}
+
+	uint32_t Histogram::getCount() const
+	{
+		return count;
+	}
+
+	uint32_t Histogram::getMax() const
+	{
+		return max;
+	}
+
+	uint32_t Histogram::getPercentile(double fraction) const
+	{
+		if (count == 0) {
+			return 0;
+		}
+
+		// the rank of the value, counting from 1
+		uint32_t rank = fraction * count + 0.5;
+		if (rank < 1) {
+			rank = 1;
+		}
+		if (rank > count) {
+			rank = count;
+		}
+
+		uint32_t seen = 0;
+		for (int i = 0; i < BUCKETS; ++i) {
+			seen += counts[i];
+			if (seen >= rank) {
+				uint32_t top = getBucketTop(i);
+				return top < max ? top : max;
+			}
+		}
+		return max;
+	}
+
+	int Histogram::getBucket(uint32_t value)
+	{
+		if (value < LINEAR_BUCKETS) {
+			return value;
+		}
+
+		// the top bit picks the power of two, and the three bits below it the sub-bucket
+		int exponent = 31 - __builtin_clz(value);
+		int sub_bucket = (value >> (exponent - 3)) & (SUB_BUCKETS - 1);
+		return LINEAR_BUCKETS + (exponent - 4) * SUB_BUCKETS + sub_bucket;
+	}
+
+	uint32_t Histogram::getBucketTop(int bucket)
+	{
+		if (bucket < LINEAR_BUCKETS) {
+			return bucket;
+		}
+
+		int exponent = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS + 4;
+		int sub_bucket = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+		uint64_t bottom = ((uint64_t)(SUB_BUCKETS + sub_bucket)) << (exponent - 3);
+		uint64_t top = bottom + (((uint64_t)1) << (exponent - 3)) - 1;
+		return top > 0xFFFFFFFF ? 0xFFFFFFFF : top;
+	}
+}
@@ -0,0 +1,52 @@
+#ifndef SRC_ED_HISTOGRAM_HPP_
+#define SRC_ED_HISTOGRAM_HPP_
+
+#include <stdint.h>
+
+namespace ED
+{
+/**
+ * Counts values into buckets that grow with the values, in fixed memory, so
+ * that percentiles can be read back to within an eighth of the value.
+ *
+ * Values below 16 each get a bucket of their own.  Above that, every power
+ * of two is split into eight buckets, the same way an HDR histogram with one
+ * significant digit in binary does, which covers the whole range of uint32_t
+ * in a couple of hundred buckets.  The largest value is also kept exactly.
+ *
+ * Recording is safe from one thread while another reads, though the reader
+ * may see a count that's a value or two behind.
+ */
+class Histogram
+{
+public:
+	static const int LINEAR_BUCKETS = 16;
+	static const int SUB_BUCKETS = 8;
+	static const int BUCKETS = LINEAR_BUCKETS + (32 - 4) * SUB_BUCKETS;
+
+	Histogram();
+
+	void record(uint32_t value);
+	void clear();
+
+	uint32_t getCount() const;
+	uint32_t getMax() const;
+
+	/**
+	 * @param  fraction from 0.0 to 1.0, 0.5 for the median
+	 * @return the largest value of the bucket the percentile falls in, or 0
+	 *         if nothing has been recorded
+	 */
+	uint32_t getPercentile(double fraction) const;
+
+private:
+	static int getBucket(uint32_t value);
+	static uint32_t getBucketTop(int bucket);
+
+	uint32_t counts[BUCKETS];
+	uint32_t count;
+	uint32_t max;
+};
+}
+
+#endif /* SRC_ED_HISTOGRAM_HPP_ */
@@ -0,0 +1,112 @@
+#include <ED/InputSnapshot.hpp>
+#include <HAL/HAL.hpp>
+#include <WPILib.h>
+
+namespace ED
+{
+	InputSnapshot::InputSnapshot() :
+		timestamp(0.0)
+	{
+		for (int j = 0; j < JOYSTICKS; ++j) {
+			Joystick& joystick = joysticks[j];
+			for (int i = 0; i < MAX_AXES; ++i) {
+				joystick.axes[i] = 0.0;
+			}
+			for (int i = 0; i < MAX_POVS; ++i) {
+				joystick.povs[i] = -1;
+			}
+			joystick.buttons = 0;
+			joystick.pressed = 0;
+			joystick.released = 0;
+		}
+	}
+
+	void InputSnapshot::capture()
+	{
+		// the driver station only sends a packet every 20 ms, and the loop runs
+		// much faster than that
+		if (!DriverStation::GetInstance().IsNewControlData() && timestamp != 0.0) {
+			for (int j = 0; j < JOYSTICKS; ++j) {
+				joysticks[j].pressed = 0;
+				joysticks[j].released = 0;
+			}
+			return;
+		}
+		timestamp = Timer::GetFPGATimestamp();
+
+		for (int j = 0; j < JOYSTICKS; ++j) {
+			Joystick& joystick = joysticks[j];
+
+			HALJoystickAxes axes;
+			axes.count = 0;
+			HALGetJoystickAxes(j, &axes);
+			for (int i = 0; i < MAX_AXES; ++i) {
+				// the same scaling as DriverStation::GetStickAxis
+				int8_t value = i < axes.count ? axes.axes[i] : 0;
+				joystick.axes[i] = value < 0 ? value / 128.0 : value / 127.0;
+			}
+
+			HALJoystickPOVs povs;
+			povs.count = 0;
+			HALGetJoystickPOVs(j, &povs);
+			for (int i = 0; i < MAX_POVS; ++i) {
+				joystick.povs[i] = i < povs.count ? povs.povs[i] : -1;
+			}
+
+			HALJoystickButtons buttons;
+			buttons.buttons = 0;
+			buttons.count = 0;
+			HALGetJoystickButtons(j, &buttons);
+			uint32_t down = buttons.count < 32 ? buttons.buttons & ((1u << buttons.count) - 1) : buttons.buttons;
+
+			joystick.pressed = down & ~joystick.buttons;
+			joystick.released = joystick.buttons & ~down;
+			joystick.buttons = down;
+		}
+	}
+
+	float InputSnapshot::getAxis(unsigned int joystick, unsigned int axis) const
+	{
+		if (joystick >= JOYSTICKS || axis >= MAX_AXES) {
+			return 0.0;
+		}
+		return joysticks[joystick].axes[axis];
+	}
+
+	bool InputSnapshot::getButton(unsigned int joystick, unsigned int button) const
+	{
+		if (joystick >= JOYSTICKS || button == 0 || button > 32) {
+			return false;
+		}
+		return (joysticks[joystick].buttons >> (button - 1)) & 1;
+	}
+
+	int InputSnapshot::getPOV(unsigned int joystick, unsigned int pov) const
+	{
+		if (joystick >= JOYSTICKS || pov >= MAX_POVS) {
+			return -1;
+		}
+		return joysticks[joystick].povs[pov];
+	}
+
+	bool InputSnapshot::wasPressed(unsigned int joystick, unsigned int button) const
+	{
+		if (joystick >= JOYSTICKS || button == 0 || button > 32) {
+			return false;
+		}
+		return (joysticks[joystick].pressed >> (button - 1)) & 1;
+	}
+
+	bool InputSnapshot::wasReleased(unsigned int joystick, unsigned int button) const
+	{
+		if (joystick >= JOYSTICKS || button == 0 || button > 32) {
+			return false;
+		}
+		return (joysticks[joystick].released >> (button - 1)) & 1;
+	}
+
+	double InputSnapshot::getTimestamp() const
+	{
+		return timestamp;
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef SRC_ED_INPUTSNAPSHOT_HPP_
+#define SRC_ED_INPUTSNAPSHOT_HPP_
+
+#include <stdint.h>
+
+namespace ED
+{
+/**
+ * Holds a copy of every joystick's axes, buttons and POVs from the driver
+ * station, taken all at once.
+ *
+ * Each call to Joystick::GetRawButton or GetRawAxis takes the DriverStation's
+ * data lock, and a packet can arrive between two of them, so reading the
+ * joysticks piecemeal through a loop is both slow and inconsistent.  Instead,
+ * capture copies everything straight from the HAL once per loop, and only
+ * when the driver station has sent something new, and everything else reads
+ * from the copy.
+ *
+ * Buttons are numbered from 1, like Joystick::GetRawButton.  Buttons, axes
+ * and POVs that the joystick doesn't have read as released, 0.0 and -1.
+ */
+class InputSnapshot
+{
+public:
+	static const int JOYSTICKS = 6;
+	static const int MAX_AXES = 12;
+	static const int MAX_POVS = 12;
+
+	InputSnapshot();
+
+	/**
+	 * copies the joysticks again if the driver station has sent a new packet,
+	 * updating which buttons have been pressed and released since the last
+	 * capture
+	 */
+	void capture();
+
+	float getAxis(unsigned int joystick, unsigned int axis) const;
+	bool getButton(unsigned int joystick, unsigned int button) const;
+	int getPOV(unsigned int joystick, unsigned int pov) const;
+
+	/**
+	 * @return whether the button went down or up since the last capture
+	 */
+	bool wasPressed(unsigned int joystick, unsigned int button) const;
+	bool wasReleased(unsigned int joystick, unsigned int button) const;
+
+	/**
+	 * @return the FPGA time at which the packet the snapshot holds was first
+	 *         seen, or 0.0 before the first
+	 */
+	double getTimestamp() const;
+
+private:
+	struct Joystick {
+		float axes[MAX_AXES];
+		int povs[MAX_POVS];
+		uint32_t buttons;
+		uint32_t pressed;
+		uint32_t released;
+	};
+
+	Joystick joysticks[JOYSTICKS];
+	double timestamp;
+};
+}
+
+#endif /* SRC_ED_INPUTSNAPSHOT_HPP_ */
@@ -0,0 +1,119 @@
+#ifndef SRC_ED_MATRIX_HPP_
+#define SRC_ED_MATRIX_HPP_
+
+namespace ED
+{
+/**
+ * A fixed-size matrix of floats for use in control loops.
+ *
+ * All storage lives inside the object, so matrices can be declared on the
+ * stack or as globals without ever touching the heap, and the compiler knows
+ * every loop bound.  Only the handful of operations needed by the estimators
+ * and controllers are provided; anything that would require a general
+ * inverse should be rearranged into scalar updates instead.
+ */
+template<int ROWS, int COLS>
+class Matrix
+{
+public:
+	float data[ROWS][COLS];
+
+	Matrix()
+	{
+		fill(0.0);
+	}
+
+	static Matrix identity()
+	{
+		Matrix result;
+		for (int i = 0; i < ROWS && i < COLS; ++i) {
+			result.data[i][i] = 1.0;
+		}
+		return result;
+	}
+
+	void fill(float value)
+	{
+		for (int r = 0; r < ROWS; ++r) {
+			for (int c = 0; c < COLS; ++c) {
+				data[r][c] = value;
+			}
+		}
+	}
+
+	float& operator()(int row, int col)
+	{
+		return data[row][col];
+	}
+
+	float operator()(int row, int col) const
+	{
+		return data[row][col];
+	}
+
+	Matrix<COLS, ROWS> transpose() const
+	{
+		Matrix<COLS, ROWS> result;
+		for (int r = 0; r < ROWS; ++r) {
+			for (int c = 0; c < COLS; ++c) {
+				result.data[c][r] = data[r][c];
+			}
+		}
+		return result;
+	}
+
+	Matrix operator+(const Matrix& other) const
+	{
+		Matrix result;
+		for (int r = 0; r < ROWS; ++r) {
+			for (int c = 0; c < COLS; ++c) {
+				result.data[r][c] = data[r][c] + other.data[r][c];
+			}
+		}
+		return result;
+	}
+
+	Matrix operator-(const Matrix& other) const
+	{
+		Matrix result;
+		for (int r = 0; r < ROWS; ++r) {
+			for (int c = 0; c < COLS; ++c) {
+				result.data[r][c] = data[r][c] - other.data[r][c];
+			}
+		}
+		return result;
+	}
+
+	Matrix operator*(float scalar) const
+	{
+		Matrix result;
+		for (int r = 0; r < ROWS; ++r) {
+			for (int c = 0; c < COLS; ++c) {
+				result.data[r][c] = data[r][c] * scalar;
+			}
+		}
+		return result;
+	}
+
+	template<int OTHER_COLS>
+	Matrix<ROWS, OTHER_COLS> operator*(const Matrix<COLS, OTHER_COLS>& other) const
+	{
+		Matrix<ROWS, OTHER_COLS> result;
+		for (int r = 0; r < ROWS; ++r) {
+			for (int c = 0; c < OTHER_COLS; ++c) {
+				float sum = 0.0;
+				for (int k = 0; k < COLS; ++k) {
+					sum += data[r][k] * other.data[k][c];
+				}
+				result.data[r][c] = sum;
+			}
+		}
+		return result;
+	}
+};
+
+template<int SIZE>
+using Vector = Matrix<SIZE, 1>;
+}
+
+#endif /* SRC_ED_MATRIX_HPP_ */
@@ -0,0 +1,111 @@
+#include <math.h>
+#include <ED/MonotoneCubic.hpp>
+
+namespace ED
+{
+	MonotoneCubic::MonotoneCubic() :
+		count(1),
+		bucket_width(1.0)
+	{
+		x[0] = 0.0;
+		y[0] = 0.0;
+		slope[0] = 0.0;
+		for (int i = 0; i < BUCKETS; ++i) {
+			bucket_start[i] = 0;
+		}
+	}
+
+	bool MonotoneCubic::fit(const float* x, const float* y, int count)
+	{
+		if (count < 2 || count > MAX_POINTS) {
+			return false;
+		}
+		for (int i = 1; i < count; ++i) {
+			if (!(x[i] > x[i - 1])) {
+				return false;
+			}
+		}
+
+		this->count = count;
+		for (int i = 0; i < count; ++i) {
+			this->x[i] = x[i];
+			this->y[i] = y[i];
+		}
+
+		// start with the average of the secants on either side of each point,
+		// and flat wherever the points turn around
+		float secant[MAX_POINTS];
+		for (int i = 0; i + 1 < count; ++i) {
+			secant[i] = (y[i + 1] - y[i]) / (x[i + 1] - x[i]);
+		}
+		slope[0] = secant[0];
+		slope[count - 1] = secant[count - 2];
+		for (int i = 1; i + 1 < count; ++i) {
+			slope[i] = secant[i - 1] * secant[i] <= 0.0 ? 0.0 : (secant[i - 1] + secant[i]) / 2.0;
+		}
+
+		// then shrink any pair of slopes steep enough to overshoot
+		for (int i = 0; i + 1 < count; ++i) {
+			if (secant[i] == 0.0) {
+				slope[i] = 0.0;
+				slope[i + 1] = 0.0;
+				continue;
+			}
+			float a = slope[i] / secant[i];
+			float b = slope[i + 1] / secant[i];
+			float length = a * a + b * b;
+			if (length > 9.0) {
+				float scale = 3.0 / sqrt(length);
+				slope[i] = scale * a * secant[i];
+				slope[i + 1] = scale * b * secant[i];
+			}
+		}
+
+		bucket_width = (x[count - 1] - x[0]) / BUCKETS;
+		int piece = 0;
+		for (int i = 0; i < BUCKETS; ++i) {
+			float bucket_x = x[0] + i * bucket_width;
+			while (piece + 2 < count && x[piece + 1] <= bucket_x) {
+				++piece;
+			}
+			bucket_start[i] = piece;
+		}
+		return true;
+	}
+
+	float MonotoneCubic::evaluate(float value) const
+	{
+		if (count < 2 || value <= x[0]) {
+			return y[0];
+		}
+		if (value >= x[count - 1]) {
+			return y[count - 1];
+		}
+
+		int bucket = (int) ((value - x[0]) / bucket_width);
+		int i = bucket_start[bucket < BUCKETS ? bucket : BUCKETS - 1];
+		while (i + 2 < count && x[i + 1] <= value) {
+			++i;
+		}
+
+		// cubic Hermite interpolation between points i and i + 1
+		float h = x[i + 1] - x[i];
+		float t = (value - x[i]) / h;
+		float t2 = t * t;
+		float t3 = t2 * t;
+		return (2.0 * t3 - 3.0 * t2 + 1.0) * y[i] +
+			(t3 - 2.0 * t2 + t) * h * slope[i] +
+			(-2.0 * t3 + 3.0 * t2) * y[i + 1] +
+			(t3 - t2) * h * slope[i + 1];
+	}
+
+	float MonotoneCubic::getMinX() const
+	{
+		return x[0];
+	}
+
+	float MonotoneCubic::getMaxX() const
+	{
+		return x[count - 1];
+	}
+}
@@ -0,0 +1,59 @@
+#ifndef SRC_ED_MONOTONECUBIC_HPP_
+#define SRC_ED_MONOTONECUBIC_HPP_
+
+namespace ED
+{
+/**
+ * A smooth curve through a list of measured points that never overshoots
+ * them.
+ *
+ * Ordinary cubic splines can bulge past the points they go through, which
+ * for something like a shooter table would mean asking for a faster shot
+ * between two measurements than at either of them.  This curve uses the
+ * Fritsch-Carlson method to keep the slopes at each point small enough that
+ * wherever the points only go up (or only go down), the curve between them
+ * does too.
+ *
+ * Finding the piece of the curve to use doesn't search: the range of x is
+ * split into equal buckets when the curve is fit, and each bucket remembers
+ * which piece it starts in, so evaluate() takes the same short time no
+ * matter where x is.
+ */
+class MonotoneCubic
+{
+public:
+	static const int MAX_POINTS = 32;
+
+	MonotoneCubic();
+
+	/**
+	 * Fits the curve to the points, which must be sorted by x with no x
+	 * repeated
+	 * @return false, leaving the curve unchanged, if there are fewer than two
+	 *         points, more than MAX_POINTS, or they aren't sorted
+	 */
+	bool fit(const float* x, const float* y, int count);
+
+	/**
+	 * @return the value of the curve at x, or of the nearest end if x is
+	 *         outside the points
+	 */
+	float evaluate(float x) const;
+
+	float getMinX() const;
+	float getMaxX() const;
+
+private:
+	static const int BUCKETS = 64;
+
+	float x[MAX_POINTS];
+	float y[MAX_POINTS];
+	float slope[MAX_POINTS];
+	int count;
+
+	unsigned char bucket_start[BUCKETS]; // the first piece in each bucket
+	float bucket_width;
+};
+}
+
+#endif /* SRC_ED_MONOTONECUBIC_HPP_ */
@@ -0,0 +1,156 @@
+#include <math.h>
+#include <ED/MotionProfile.hpp>
+
+namespace ED
+{
+	static MotionProfile::State integrate(const MotionProfile::State& state, float jerk, float time)
+	{
+		MotionProfile::State result;
+		result.position = state.position + state.velocity * time + state.acceleration * time * time / 2.0 + jerk * time * time * time / 6.0;
+		result.velocity = state.velocity + state.acceleration * time + jerk * time * time / 2.0;
+		result.acceleration = state.acceleration + jerk * time;
+		return result;
+	}
+
+	MotionProfile::MotionProfile() :
+		start(0.0),
+		direction(1.0)
+	{
+		plan(0.0, 0.0, 1.0, 1.0, 0.0);
+	}
+
+	void MotionProfile::plan(float start, float distance, float max_velocity, float max_acceleration, float max_jerk)
+	{
+		this->start = start;
+		direction = distance < 0.0 ? -1.0 : 1.0;
+		distance = fabs(distance);
+
+		end.position = 0.0;
+		end.velocity = 0.0;
+		end.acceleration = 0.0;
+		if (distance == 0.0) {
+			// already there, and the ramps below would divide zero by zero
+			for (int i = 0; i < PHASES; ++i) {
+				phase_start[i] = end;
+				phase_jerk[i] = 0.0;
+				phase_end_time[i] = 0.0;
+			}
+			return;
+		}
+
+		// find the peak acceleration and the time spent jerking up to it,
+		// assuming for now that the move is long enough to reach full speed
+		float velocity = max_velocity;
+		float acceleration;
+		float jerk_time;
+		if (max_jerk <= 0.0) {
+			acceleration = max_acceleration;
+			jerk_time = 0.0;
+		}
+		else if (max_velocity * max_jerk >= max_acceleration * max_acceleration) {
+			acceleration = max_acceleration;
+			jerk_time = acceleration / max_jerk;
+		}
+		else {
+			// full speed is reached before full acceleration
+			acceleration = sqrt(max_velocity * max_jerk);
+			jerk_time = acceleration / max_jerk;
+		}
+
+		// speeding up and slowing down are symmetric, so each covers half the
+		// peak velocity times the time they take
+		float ramp_time = velocity / acceleration + jerk_time;
+		if (velocity * ramp_time > distance) {
+			// too short to reach full speed, so find the peak velocity that makes the
+			// ramps cover exactly the distance
+			if (max_jerk <= 0.0) {
+				velocity = sqrt(distance * acceleration);
+			}
+			else {
+				float ratio = max_acceleration / max_jerk;
+				velocity = max_acceleration / 2.0 * (-ratio + sqrt(ratio * ratio + 4.0 * distance / max_acceleration));
+				if (velocity * max_jerk < max_acceleration * max_acceleration) {
+					// too short to reach full acceleration either
+					velocity = cbrt(distance * distance * max_jerk / 4.0);
+					acceleration = sqrt(velocity * max_jerk);
+				}
+				jerk_time = acceleration / max_jerk;
+			}
+			ramp_time = velocity / acceleration + jerk_time;
+		}
+
+		float constant_acceleration_time = ramp_time - 2.0 * jerk_time;
+		if (constant_acceleration_time < 0.0) {
+			constant_acceleration_time = 0.0;
+		}
+		float cruise_time = velocity > 0.0 ? (distance - velocity * ramp_time) / velocity : 0.0;
+		if (cruise_time < 0.0) {
+			cruise_time = 0.0;
+		}
+
+		float jerk = max_jerk <= 0.0 ? 0.0 : max_jerk;
+		float durations[PHASES] = {
+			jerk_time, constant_acceleration_time, jerk_time,
+			cruise_time,
+			jerk_time, constant_acceleration_time, jerk_time
+		};
+		float jerks[PHASES] = { jerk, 0.0, -jerk, 0.0, -jerk, 0.0, jerk };
+
+		// setting the acceleration at the start of each phase, instead of only
+		// integrating the jerk, is what lets a trapezoid's accelerations jump
+		float accelerations[PHASES] = { 0.0, acceleration, acceleration, 0.0, 0.0, -acceleration, -acceleration };
+
+		State state = { 0.0, 0.0, 0.0 };
+		float time = 0.0;
+		for (int i = 0; i < PHASES; ++i) {
+			state.acceleration = accelerations[i];
+			phase_start[i] = state;
+			phase_jerk[i] = jerks[i];
+
+			time += durations[i];
+			phase_end_time[i] = time;
+			state = integrate(state, jerks[i], durations[i]);
+		}
+
+		// don't let rounding leave the profile short of its target
+		end.position = distance;
+	}
+
+	MotionProfile::State MotionProfile::sample(float time) const
+	{
+		State state = end;
+		float phase_start_time = 0.0;
+		if (time < 0.0) {
+			state = phase_start[0];
+		}
+		else {
+			for (int i = 0; i < PHASES; ++i) {
+				if (time < phase_end_time[i]) {
+					state = integrate(phase_start[i], phase_jerk[i], time - phase_start_time);
+					break;
+				}
+				phase_start_time = phase_end_time[i];
+			}
+		}
+
+		state.position = start + direction * state.position;
+		state.velocity *= direction;
+		state.acceleration *= direction;
+		return state;
+	}
+
+	float MotionProfile::getDuration() const
+	{
+		return phase_end_time[PHASES - 1];
+	}
+
+	float MotionProfile::getStart() const
+	{
+		return start;
+	}
+
+	float MotionProfile::getEnd() const
+	{
+		return start + direction * end.position;
+	}
+}
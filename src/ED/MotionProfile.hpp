@@ -0,0 +1,64 @@
+#ifndef SRC_ED_MOTIONPROFILE_HPP_
+#define SRC_ED_MOTIONPROFILE_HPP_
+
+namespace ED
+{
+/**
+ * A one dimensional move from rest to rest that never exceeds a maximum
+ * velocity, acceleration, or jerk.
+ *
+ * With a jerk limit the profile is an S-curve made of seven phases: jerk up,
+ * constant acceleration, jerk down, cruise, and the same three mirrored to
+ * stop.  Without one (a jerk limit of 0.0) the jerk phases take no time and
+ * the profile is the usual trapezoid.  Short moves that can't reach the
+ * velocity or acceleration limits simply skip the phases that would have
+ * held them.
+ *
+ * The units are whatever the caller uses, as long as they're consistent:
+ * centimeters and seconds for Mobility, degrees and seconds for the arms.
+ */
+class MotionProfile
+{
+public:
+	struct State {
+		float position;
+		float velocity;
+		float acceleration;
+	};
+
+	MotionProfile();
+
+	/**
+	 * Plans a move of the given distance from a standstill at start
+	 * @param start            starting position
+	 * @param distance         signed distance to move
+	 * @param max_velocity     must be positive
+	 * @param max_acceleration must be positive
+	 * @param max_jerk         0.0 for a trapezoidal profile
+	 */
+	void plan(float start, float distance, float max_velocity, float max_acceleration, float max_jerk);
+
+	/**
+	 * @return the state of the move at time seconds after it started,
+	 *         holding at the end once the move is over
+	 */
+	State sample(float time) const;
+
+	float getDuration() const;
+	float getStart() const;
+	float getEnd() const;
+
+private:
+	static const int PHASES = 7;
+
+	float start;
+	float direction;
+
+	float phase_end_time[PHASES];
+	float phase_jerk[PHASES];
+	State phase_start[PHASES];
+	State end;
+};
+}
+
+#endif /* SRC_ED_MOTIONPROFILE_HPP_ */
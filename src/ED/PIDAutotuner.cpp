@@ -0,0 +1,166 @@
+#include <ED/PIDAutotuner.hpp>
+#include <ED/PIDManager.hpp>
+
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+namespace ED
+{
+	PIDAutotuner::PIDAutotuner(PIDManager& manager, const Config& config) :
+		manager(manager),
+		config(config),
+		status(Status::RUNNING),
+		time(0.0),
+		bias(config.initial_bias),
+		high(config.target > manager.returnPIDInput()),
+		switched(false),
+		settled(false),
+		cycle_start(-1.0),
+		cycle_time_high(0.0),
+		cycle_max(0.0),
+		cycle_min(0.0),
+		cycle_count(0),
+		amplitude_sum(0.0),
+		period_sum(0.0),
+		ultimate_gain(0.0),
+		ultimate_period(0.0)
+	{
+
+	}
+
+	PIDAutotuner::Status PIDAutotuner::process(float period)
+	{
+		if (status != Status::RUNNING) {
+			return status;
+		}
+		time += period;
+
+		float input = manager.returnPIDInput();
+		float error = config.target - input;
+		if (time > config.timeout || (switched && fabs(error) > config.max_error)) {
+			stop();
+			return status;
+		}
+
+		bool was_high = high;
+		if (error > config.hysteresis) {
+			high = true;
+		}
+		else if (error < -config.hysteresis) {
+			high = false;
+		}
+		if (high != was_high) {
+			switched = true;
+		}
+
+		if (cycle_start >= 0.0) {
+			cycle_max = fmax(cycle_max, input);
+			cycle_min = fmin(cycle_min, input);
+			if (was_high) {
+				cycle_time_high += period;
+			}
+		}
+
+		// each cycle runs from one switch up to the next
+		if (high && !was_high) {
+			if (cycle_start >= 0.0) {
+				float cycle_period = time - cycle_start;
+
+				// the first cycle is still settling from wherever the input started
+				if (settled) {
+					amplitude_sum += (cycle_max - cycle_min) / 2.0;
+					period_sum += cycle_period;
+					++cycle_count;
+				}
+				settled = true;
+
+				// push the bias toward whichever way the input is slower to go
+				float time_low = cycle_period - cycle_time_high;
+				bias += config.relay_amplitude * (cycle_time_high - time_low) / cycle_period / 2.0;
+				bias = fmin(fmax(bias, -1.0 + config.relay_amplitude), 1.0 - config.relay_amplitude);
+
+				if (cycle_count == config.cycles) {
+					finish();
+					return status;
+				}
+			}
+
+			cycle_start = time;
+			cycle_time_high = 0.0;
+			cycle_max = input;
+			cycle_min = input;
+		}
+
+		manager.usePIDOutput(high ? bias + config.relay_amplitude : bias - config.relay_amplitude, 0.0);
+		return status;
+	}
+
+	void PIDAutotuner::stop()
+	{
+		if (status == Status::RUNNING) {
+			status = Status::FAILED;
+		}
+		manager.usePIDOutput(0.0, 0.0);
+	}
+
+	PIDAutotuner::Status PIDAutotuner::getStatus() const
+	{
+		return status;
+	}
+
+	int PIDAutotuner::getCycleCount() const
+	{
+		return cycle_count;
+	}
+
+	PIDAutotuner::Gains PIDAutotuner::getGains() const
+	{
+		Gains gains;
+		switch (config.rule) {
+		case Rule::PI:
+			gains.p = 0.45 * ultimate_gain;
+			gains.i = 0.54 * ultimate_gain / ultimate_period;
+			gains.d = 0.0;
+			break;
+
+		case Rule::PID:
+			gains.p = 0.6 * ultimate_gain;
+			gains.i = 1.2 * ultimate_gain / ultimate_period;
+			gains.d = 0.075 * ultimate_gain * ultimate_period;
+			break;
+		}
+
+		// the bias is the feed-forward output at the target
+		float scale = config.feed_forward_scale != nullptr ? config.feed_forward_scale(config.target) : 1.0;
+		gains.f = scale != 0.0 ? bias / scale : 0.0;
+		return gains;
+	}
+
+	float PIDAutotuner::getUltimateGain() const
+	{
+		return ultimate_gain;
+	}
+
+	float PIDAutotuner::getUltimatePeriod() const
+	{
+		return ultimate_period;
+	}
+
+	void PIDAutotuner::finish()
+	{
+		float amplitude = amplitude_sum / cycle_count;
+		ultimate_period = period_sum / cycle_count;
+
+		// the hysteresis delays each switch, which the describing function of a
+		// relay with hysteresis accounts for
+		if (amplitude <= config.hysteresis || ultimate_period <= 0.0) {
+			stop();
+			return;
+		}
+		ultimate_gain = 4.0 * config.relay_amplitude / (M_PI * sqrt(amplitude * amplitude - config.hysteresis * config.hysteresis));
+
+		status = Status::FINISHED;
+		manager.usePIDOutput(0.0, 0.0);
+	}
+}
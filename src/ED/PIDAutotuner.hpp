@@ -0,0 +1,109 @@
+#ifndef SRC_ED_PIDAUTOTUNER_HPP_
+#define SRC_ED_PIDAUTOTUNER_HPP_
+
+#include <ED/PIDManager.hpp>
+
+namespace ED
+{
+/**
+ * Finds PID and feed-forward gains for any PIDManager by relay feedback.
+ *
+ * In place of the PID loop, the output is switched between bias + amplitude
+ * whenever the input is below the target and bias - amplitude whenever it's
+ * above, which makes almost any mechanism oscillate steadily around the
+ * target.  The size and period of that oscillation give the ultimate gain
+ * and period (Astrom and Hagglund), which the Ziegler-Nichols rules turn
+ * into gains.
+ *
+ * The bias is adjusted each cycle until the output spends as long high as
+ * low, at which point it's the output that holds the mechanism at the target
+ * against gravity or friction, and so makes the feed-forward.
+ *
+ * The PIDManager must be disabled while tuning, and the tuner only calls its
+ * returnPIDInput and usePIDOutput, so the subclass's own limits still apply.
+ */
+class PIDAutotuner
+{
+public:
+	enum Rule {
+		PI, // for rates, where a derivative only amplifies noise
+		PID
+	};
+
+	enum Status {
+		RUNNING,
+		FINISHED,
+		FAILED
+	};
+
+	struct Config {
+		float target;
+		float relay_amplitude; // output above and below the bias
+		float initial_bias; // output to start the bias at
+		float hysteresis; // input error that must be crossed before switching, to ignore noise
+		int cycles; // oscillations to measure, after one to settle
+		float max_error; // input error after the first switch that aborts the tuning
+		float timeout; // seconds
+		Rule rule;
+		float (*feed_forward_scale)(float target); // what the feed-forward coefficient is multiplied by at a target, nullptr for nothing
+	};
+
+	typedef PIDManager::Gains Gains;
+
+	PIDAutotuner(PIDManager& manager, const Config& config);
+
+	/**
+	 * Reads the input and switches the output
+	 * @param period seconds since the last call
+	 * @return the status after this step; the output is stopped once the
+	 *         tuning finishes or fails
+	 */
+	Status process(float period);
+
+	/**
+	 * Stops the output, failing the tuning if it isn't finished
+	 */
+	void stop();
+
+	Status getStatus() const;
+	int getCycleCount() const;
+
+	/**
+	 * @return the gains found, valid once the status is FINISHED
+	 */
+	Gains getGains() const;
+
+	float getUltimateGain() const;
+	float getUltimatePeriod() const; // seconds
+
+private:
+	void finish();
+
+	PIDManager& manager;
+	const Config config;
+
+	Status status;
+	float time;
+	float bias;
+	bool high;
+	bool switched;
+	bool settled;
+
+	float cycle_start;
+	float cycle_time_high;
+	float cycle_max;
+	float cycle_min;
+
+	int cycle_count;
+	float amplitude_sum;
+	float period_sum;
+
+	float ultimate_gain;
+	float ultimate_period;
+
+	PIDAutotuner(const PIDAutotuner&) = delete;
+	PIDAutotuner& operator=(const PIDAutotuner&) = delete;
+};
+}
+
+#endif /* SRC_ED_PIDAUTOTUNER_HPP_ */
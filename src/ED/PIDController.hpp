@@ -0,0 +1,352 @@
+#ifndef SRC_ED_PIDCONTROLLER_HPP_
+#define SRC_ED_PIDCONTROLLER_HPP_
+
+#include <chrono>
+#include <math.h>
+
+namespace ED
+{
+/**
+ * passes the derivative through as it is
+ */
+class NoDerivativeFilter
+{
+public:
+	float filter(float derivative, float cycle_time)
+	{
+		return derivative;
+	}
+
+	void reset()
+	{
+
+	}
+};
+
+/**
+ * smooths the derivative with a first order low pass filter, so that sensor
+ * noise isn't amplified into the output
+ */
+class LowPassDerivativeFilter
+{
+public:
+	LowPassDerivativeFilter() :
+		time_constant(0.0),
+		value(0.0)
+	{
+
+	}
+
+	/**
+	 * @param seconds the time constant of the filter; 0.0 turns it off
+	 */
+	void setTimeConstant(float seconds)
+	{
+		time_constant = seconds;
+	}
+
+	float filter(float derivative, float cycle_time)
+	{
+		value += cycle_time / (time_constant + cycle_time) * (derivative - value);
+		return value;
+	}
+
+	void reset()
+	{
+		value = 0.0;
+	}
+
+private:
+	float time_constant;
+	float value;
+};
+
+/**
+ * lets the accumulated error grow without limit
+ */
+class NoIntegratorClamp
+{
+public:
+	float clamp(float accumulated_error)
+	{
+		return accumulated_error;
+	}
+};
+
+/**
+ * keeps the accumulated error between a minimum and a maximum
+ */
+class RangeIntegratorClamp
+{
+public:
+	RangeIntegratorClamp() :
+		min(0.0),
+		max(0.0)
+	{
+
+	}
+
+	/**
+	 * to turn the clamp off, set the minimum equal to or greater than the maximum
+	 */
+	void setRange(float min, float max)
+	{
+		this->min = min;
+		this->max = max;
+	}
+
+	float clamp(float accumulated_error)
+	{
+		if (min < max) {
+			if (accumulated_error > max) {
+				return max;
+			}
+			if (accumulated_error < min) {
+				return min;
+			}
+		}
+		return accumulated_error;
+	}
+
+private:
+	float min;
+	float max;
+};
+
+/**
+ * The loop of PIDManager, with every part of it picked at compile time so
+ * that process compiles down to straight line code.
+ *
+ * PIDManager calls its subclass through virtual functions three times a
+ * loop, and locks three mutexes, which the compiler can't see through.  Here
+ * the subclass is Derived itself, in the curiously recurring template
+ * pattern: it defines
+ *   float returnPIDInput();
+ *   void usePIDOutput(float pid_output, float feed_forward);
+ * and may hide getFeedForwardOutput, all of them either public or with
+ * PIDController as a friend.  The derivative filter and the integrator clamp
+ * are classes like the ones above, configured through getDerivativeFilter
+ * and getIntegratorClamp.  Nothing is allocated, so controllers can be
+ * globals.
+ *
+ * The derivative is taken on the input, not the error, so that changing the
+ * target doesn't kick the output.  The error is only accumulated within the
+ * i-zone of the target, when there is one.
+ *
+ * Unlike PIDManager there are no locks, so a controller must only be used
+ * from one thread.
+ */
+template<class Derived, class DerivativeFilter = NoDerivativeFilter, class IntegratorClamp = NoIntegratorClamp>
+class PIDController
+{
+public:
+	/**
+	 * runs the loop once, timing the cycle with the monotonic clock
+	 */
+	void process()
+	{
+		std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now();
+		float cycle_time = std::chrono::duration<float>(timestamp - last_timestamp).count();
+		last_timestamp = timestamp;
+		process(cycle_time);
+	}
+
+	/**
+	 * runs the loop once
+	 * @param cycle_time the seconds since the last run
+	 */
+	void process(float cycle_time)
+	{
+		Derived& derived = static_cast<Derived&>(*this);
+		float input = derived.returnPIDInput();
+		float error = target - input;
+
+		if (enabled && cycle_time > 0.0) {
+			if (i_zone == 0.0 || fabs(error) < i_zone) {
+				// use average error for trapezoidal sum
+				accumulated_error = integrator_clamp.clamp(accumulated_error + cycle_time * (error + last_error) / 2.0);
+			}
+			float derivative = derivative_filter.filter(-(input - last_input) / cycle_time, cycle_time);
+
+			last_output = p * error + i * accumulated_error + d * derivative;
+			derived.usePIDOutput(last_output, feed_forward_output);
+		}
+
+		last_input = input;
+		last_error = error;
+	}
+
+	void enable(bool enable)
+	{
+		if (enable && !enabled) {
+			// start the history over, so the first loop doesn't see a jump
+			if (clear_accumulated_error) {
+				accumulated_error = 0.0;
+			}
+			last_input = static_cast<Derived&>(*this).returnPIDInput();
+			last_error = target - last_input;
+			last_timestamp = std::chrono::steady_clock::now();
+			derivative_filter.reset();
+		}
+		enabled = enable;
+	}
+
+	bool isEnabled() const
+	{
+		return enabled;
+	}
+
+	void setTarget(float target)
+	{
+		feed_forward_output = static_cast<Derived&>(*this).getFeedForwardOutput(target);
+		if (clear_accumulated_error && target != this->target) {
+			accumulated_error = 0.0;
+		}
+		this->target = target;
+	}
+
+	float getTarget() const
+	{
+		return target;
+	}
+
+	void setPID(float p, float i, float d)
+	{
+		this->p = p;
+		this->i = i;
+		this->d = d;
+	}
+
+	float getP() const
+	{
+		return p;
+	}
+
+	float getI() const
+	{
+		return i;
+	}
+
+	float getD() const
+	{
+		return d;
+	}
+
+	/**
+	 * sets the feed-forward coefficient, recalculating the feed-forward
+	 * output for the current target
+	 */
+	void setF(float f)
+	{
+		this->f = f;
+		feed_forward_output = static_cast<Derived&>(*this).getFeedForwardOutput(target);
+	}
+
+	float getF() const
+	{
+		return f;
+	}
+
+	/**
+	 * configures the controller to clear the accumulated error every time it's
+	 * reenabled or the target is changed
+	 */
+	void autoClearAccumulatedError(bool clear)
+	{
+		clear_accumulated_error = clear;
+	}
+
+	void clearAccumulatedError()
+	{
+		accumulated_error = 0.0;
+	}
+
+	/**
+	 * sets the absolute range around the target outside of which the error
+	 * isn't accumulated; 0.0 accumulates it everywhere
+	 */
+	void setAbsoluteIZone(float range)
+	{
+		i_zone = fabs(range);
+	}
+
+	DerivativeFilter& getDerivativeFilter()
+	{
+		return derivative_filter;
+	}
+
+	IntegratorClamp& getIntegratorClamp()
+	{
+		return integrator_clamp;
+	}
+
+	float getLastInput() const
+	{
+		return last_input;
+	}
+
+	float getLastOutput() const
+	{
+		return last_output;
+	}
+
+protected:
+	PIDController(float p, float i, float d, float f = 0.0) :
+		enabled(true),
+		target(0.0),
+
+		p(p),
+		i(i),
+		d(d),
+		f(f),
+
+		last_input(0.0),
+		last_output(0.0),
+		feed_forward_output(0.0),
+
+		last_error(0.0),
+		accumulated_error(0.0),
+		clear_accumulated_error(false),
+
+		i_zone(0.0),
+
+		last_timestamp(std::chrono::steady_clock::now())
+	{
+
+	}
+
+	/**
+	 * hide this in Derived to give a feed-forward output for each new target
+	 */
+	float getFeedForwardOutput(float new_target)
+	{
+		return 0.0;
+	}
+
+private:
+	bool enabled;
+	float target;
+
+	float p;
+	float i;
+	float d;
+	float f;
+
+	float last_input;
+	float last_output;
+	float feed_forward_output;
+
+	float last_error;
+	float accumulated_error;
+	bool clear_accumulated_error;
+
+	float i_zone;
+
+	DerivativeFilter derivative_filter;
+	IntegratorClamp integrator_clamp;
+
+	std::chrono::steady_clock::time_point last_timestamp;
+};
+}
+
+#endif /* SRC_ED_PIDCONTROLLER_HPP_ */
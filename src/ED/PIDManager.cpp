@@ -7,27 +7,41 @@ using namespace std::chrono;
 
 namespace ED
 {
-	PIDManager::PIDManager(float p, float i, float d) :
+	PIDManager::PIDManager(float p, float i, float d, float f) :
 		enabled(true),
 		target(0.0),
 		
 		p(p),
 		i(i),
 		d(d),
+		f(f),
 		
 		last_input(0.0),
 		last_output(0.0),
 		feed_forward_output(0.0),
 		
 		last_error(0.0),
-		accumulated_error(0.0),
+		integral(0.0),
 		clear_accumulated_error(false),
 		
 		max_accumulated_error(0.0),
 		min_accumulated_error(0.0),
 		i_zone(0.0),
 		
-		last_timestamp(duration_cast<nanoseconds>(system_clock::now().time_since_epoch())),
+		derivative_time_constant(0.0),
+		filtered_derivative(0.0),
+		
+		proportional_weight(1.0),
+		derivative_weight(0.0),
+		last_target(0.0),
+		
+		min_output(0.0),
+		max_output(0.0),
+		tracking_time(0.0),
+		
+		slot_count(0),
+		
+		last_timestamp(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())),
 
 		enable_mutex(),
 		process_mutex(),
@@ -43,52 +57,71 @@ namespace ED
 
 	void PIDManager::process()
 	{
-		nanoseconds timestamp = duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch());
+		nanoseconds timestamp = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch());
 		float input = returnPIDInput();
 
 		user_mutex.lock();
 		process_mutex.lock();
-		float error = getTarget() - input;
+		float target = getTarget();
+		float error = target - input;
 
 		if (isEnabled()) {
 			typedef duration<float> float_seconds;
-			float cycle_time = duration_cast<float_seconds>(last_timestamp - timestamp).count();
+			float cycle_time = duration_cast<float_seconds>(timestamp - last_timestamp).count();
 			
-			// create a temporaty copy so that thread locking is unnecessary
-			float i_zone = this->i_zone;
-			// because i_zone is read from twice here
-			bool in_i_zone = fabs(error) < i_zone && i_zone != 0.0;
-			if (in_i_zone) {
-				// use average error for trapezoidal sum
-				accumulated_error += cycle_time * (error + last_error) / 2.0;
+			if (cycle_time > 0.0) {
+				// create a temporaty copy so that thread locking is unnecessary
+				float i_zone = this->i_zone;
+				// because i_zone is read from twice here
+				bool in_i_zone = fabs(error) < i_zone || i_zone == 0.0;
+				if (in_i_zone) {
+					// use average error for trapezoidal sum
+					integral += i * cycle_time * (error + last_error) / 2.0;
+					clampIntegral();
+				}
 				
-				if (min_accumulated_error < max_accumulated_error) {
-					if (accumulated_error > max_accumulated_error) {
-						accumulated_error = max_accumulated_error;
-					}
-					else if (accumulated_error < min_accumulated_error) {
-						accumulated_error = min_accumulated_error;
-					}
+				// with the default weight of 0.0 this is the rate of change of the
+				// input alone, which doesn't jump when the target does
+				float derivative = (derivative_weight * (target - last_target) - (input - last_input)) / cycle_time;
+				if (derivative_time_constant > 0.0) {
+					filtered_derivative += cycle_time / (derivative_time_constant + cycle_time) * (derivative - filtered_derivative);
+				}
+				else {
+					filtered_derivative = derivative;
 				}
 			}
 			
-			float pid = p * error + d * (input - last_input) / cycle_time;
-			pid = in_i_zone ? pid : pid + i * accumulated_error;
+			float pid = p * (proportional_weight * target - input) + integral + d * filtered_derivative;
+			
+			if (min_output < max_output) {
+				float output = pid + feed_forward_output;
+				float limited_output = output > max_output ? max_output : (output < min_output ? min_output : output);
+				if (limited_output != output) {
+					// pull the integral term back by the part of the output that didn't fit
+					if (i != 0.0 && cycle_time > 0.0) {
+						float fraction = cycle_time < tracking_time ? cycle_time / tracking_time : 1.0;
+						integral += fraction * (limited_output - output);
+						clampIntegral();
+					}
+					pid = limited_output - feed_forward_output;
+				}
+			}
 
 			// use lock_guard to be exception safe since usePIDOutput could contain anything
 			{ lock_guard<mutex> lock(enable_mutex);
 				if (isEnabled()) { // by now we may have been disabled
 					usePIDOutput(pid, feed_forward_output);
-					last_input = input;
 					last_output = pid;
 				}
 			}
 		}
 
-		// last_error and last_timestamp are set inside
+		// last_error, last_input and last_timestamp are set inside
 		// the enable function, so they have to be protected
 		// by mutexes
 		last_error = error;
+		last_input = input;
+		last_target = target;
 		last_timestamp = timestamp;
 
 		process_mutex.unlock();
@@ -105,10 +138,13 @@ namespace ED
 				// only reset the history when we are reenabling
 				process_mutex.lock();
 				if (clear_accumulated_error) {
-					accumulated_error = 0.0;
+					integral = 0.0;
 				}
-				last_error = getTarget() - returnPIDInput();
-				last_timestamp = duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch());
+				last_input = returnPIDInput();
+				last_error = getTarget() - last_input;
+				last_target = getTarget();
+				filtered_derivative = 0.0;
+				last_timestamp = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch());
 				process_mutex.unlock();
 			}
 			else {
@@ -129,6 +165,21 @@ namespace ED
 	void PIDManager::setTarget(float target)
 	{
 		process_mutex.lock();
+		if (slot_count > 0) {
+			applyGains(interpolateGains(target));
+		}
+		feed_forward_output = getFeedForwardOutput(target);
+		this->target = target;
+		process_mutex.unlock();
+	}
+	
+	void PIDManager::setTarget(float target, int slot)
+	{
+		process_mutex.lock();
+		if (slot_count > 0) {
+			slot = slot < 0 ? 0 : (slot >= slot_count ? slot_count - 1 : slot);
+			applyGains(slot_gains[slot]);
+		}
 		feed_forward_output = getFeedForwardOutput(target);
 		this->target = target;
 		process_mutex.unlock();
@@ -142,6 +193,7 @@ namespace ED
 	void PIDManager::setPID(float p, float i, float d)
 	{
 		process_mutex.lock();
+		slot_count = 0;
 		this->p = p;
 		this->i = i;
 		this->d = d;
@@ -163,6 +215,64 @@ namespace ED
 		return d;
 	}
 	
+	bool PIDManager::addGainSlot(float operating_point, const Gains& gains)
+	{
+		process_mutex.lock();
+		int slot = 0;
+		while (slot < slot_count && slot_points[slot] < operating_point) {
+			++slot;
+		}
+		bool added = slot_count < MAX_GAIN_SLOTS && (slot == slot_count || slot_points[slot] != operating_point);
+		if (added) {
+			// keep the slots in order of operating point
+			for (int j = slot_count; j > slot; --j) {
+				slot_points[j] = slot_points[j - 1];
+				slot_gains[j] = slot_gains[j - 1];
+			}
+			slot_points[slot] = operating_point;
+			slot_gains[slot] = gains;
+			++slot_count;
+		}
+		process_mutex.unlock();
+		return added;
+	}
+	
+	void PIDManager::clearGainSlots()
+	{
+		process_mutex.lock();
+		slot_count = 0;
+		process_mutex.unlock();
+	}
+	
+	int PIDManager::getGainSlotCount() const
+	{
+		return slot_count;
+	}
+	
+	PIDManager::Gains PIDManager::getScheduledGains(float target)
+	{
+		process_mutex.lock();
+		Gains gains = { p, i, d, f };
+		if (slot_count > 0) {
+			gains = interpolateGains(target);
+		}
+		process_mutex.unlock();
+		return gains;
+	}
+	
+	void PIDManager::setF(float f)
+	{
+		process_mutex.lock();
+		this->f = f;
+		feed_forward_output = getFeedForwardOutput(target);
+		process_mutex.unlock();
+	}
+	
+	float PIDManager::getF() const
+	{
+		return f;
+	}
+	
 	void PIDManager::autoClearAccumulatedError(bool clear)
 	{
 		clear_accumulated_error = clear;
@@ -171,7 +281,7 @@ namespace ED
 	void PIDManager::clearAccumulatedError()
 	{
 		process_mutex.lock();
-		accumulated_error = 0.0;
+		integral = 0.0;
 		process_mutex.unlock();
 	}
 	
@@ -188,6 +298,30 @@ namespace ED
 		process_mutex.unlock();
 	}
 	
+	void PIDManager::setDerivativeFilter(float time_constant)
+	{
+		process_mutex.lock();
+		derivative_time_constant = time_constant > 0.0 ? time_constant : 0.0;
+		process_mutex.unlock();
+	}
+	
+	void PIDManager::setTargetWeights(float proportional_weight, float derivative_weight)
+	{
+		process_mutex.lock();
+		this->proportional_weight = proportional_weight;
+		this->derivative_weight = derivative_weight;
+		process_mutex.unlock();
+	}
+	
+	void PIDManager::setBackCalculation(float min_output, float max_output, float tracking_time)
+	{
+		process_mutex.lock();
+		this->min_output = min_output;
+		this->max_output = max_output;
+		this->tracking_time = tracking_time;
+		process_mutex.unlock();
+	}
+	
 	float PIDManager::getLastInput() const
 	{
 		return last_input;
@@ -198,6 +332,58 @@ namespace ED
 		return last_output;
 	}
 	
+	void PIDManager::clampIntegral()
+	{
+		if (min_accumulated_error < max_accumulated_error && i != 0.0) {
+			// a negative coefficient swaps which limit is the top
+			float first = i * min_accumulated_error;
+			float second = i * max_accumulated_error;
+			float max_integral = first > second ? first : second;
+			float min_integral = first > second ? second : first;
+			if (integral > max_integral) {
+				integral = max_integral;
+			}
+			else if (integral < min_integral) {
+				integral = min_integral;
+			}
+		}
+	}
+	
+	void PIDManager::applyGains(const Gains& gains)
+	{
+		// the integral term is already output, so it carries over as it is
+		p = gains.p;
+		i = gains.i;
+		d = gains.d;
+		f = gains.f;
+	}
+	
+	PIDManager::Gains PIDManager::interpolateGains(float target) const
+	{
+		// interpolate between the slots on either side of the target
+		int upper = 0;
+		while (upper < slot_count && slot_points[upper] <= target) {
+			++upper;
+		}
+		if (upper == 0) {
+			return slot_gains[0];
+		}
+		if (upper == slot_count) {
+			return slot_gains[slot_count - 1];
+		}
+		
+		const Gains& low = slot_gains[upper - 1];
+		const Gains& high = slot_gains[upper];
+		float t = (target - slot_points[upper - 1]) / (slot_points[upper] - slot_points[upper - 1]);
+		
+		Gains gains;
+		gains.p = low.p + t * (high.p - low.p);
+		gains.i = low.i + t * (high.i - low.i);
+		gains.d = low.d + t * (high.d - low.d);
+		gains.f = low.f + t * (high.f - low.f);
+		return gains;
+	}
+	
 	float PIDManager::getFeedForwardOutput(float new_target)
 	{
 		return 0.0;
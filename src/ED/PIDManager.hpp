@@ -37,7 +37,8 @@ namespace ED
  * there is no implemented "output range," because that feature does not
  * clearly define what happens when the actual PID output naturally falls
  * outside that range.  In addition, an output range is very easily
- * implemented inside usePIDOutput.
+ * implemented inside usePIDOutput.  The exception is setBackCalculation,
+ * which defines exactly that: the integral term is unwound.
  *
  * There is no input range, because setting maximum and minimum values for
  * sensor input is easily implemented in the returnPIDInput input function,
@@ -57,6 +58,15 @@ namespace ED
 class PIDManager
 {
 public:
+	static const int MAX_GAIN_SLOTS = 8;
+	
+	struct Gains {
+		float p;
+		float i;
+		float d;
+		float f;
+	};
+	
 	virtual ~PIDManager();
 
 	void process();
@@ -67,17 +77,60 @@ public:
 	void enable(bool enable);
 	bool isEnabled() const;
 	
+	/**
+	 * sets the target, and if there is a gain schedule, switches to the gains
+	 * scheduled for the target
+	 */
 	void setTarget(float);
+	/**
+	 * sets the target, switching to the gains of one slot of the schedule
+	 * rather than the ones interpolated for the target
+	 * @param target the new target
+	 * @param slot   the index of the slot, in order of operating point
+	 */
+	void setTarget(float target, int slot);
 	float getTarget() const;
 	
 	/**
-	 * sets the proportional, integral, and derivative coefficients
+	 * sets the proportional, integral, and derivative coefficients,
+	 * replacing any gain schedule
 	 * @param p the new proportional coefficient
 	 * @param i the new integral coefficient
 	 * @param d the new derivative coefficient
 	 */
 	void setPID(float p, float i, float d);
 	
+	/**
+	 * adds a slot to the gain schedule
+	 *
+	 * Mechanisms often need different gains in different parts of their
+	 * range, like an arm that rests on a hard stop at the bottom but hangs
+	 * from its motor at the top.  Each slot holds the gains for one operating
+	 * point, and setTarget switches to gains interpolated between the slots
+	 * on either side of the new target, or those of the nearest slot beyond
+	 * the ends.
+	 *
+	 * The switch is bumpless: the integral term is kept as output, each
+	 * cycle's error is integrated with the gain in use at the time, so new
+	 * gains only change how it grows from then on, and an i of 0.0 holds it
+	 * where it is.
+	 * @param  operating_point the target at which these gains apply
+	 * @param  gains           the coefficients, including feed-forward
+	 * @return false if there are already MAX_GAIN_SLOTS slots, or one at the
+	 *         same operating point
+	 */
+	bool addGainSlot(float operating_point, const Gains& gains);
+	/**
+	 * removes every slot from the gain schedule, keeping the current gains
+	 */
+	void clearGainSlots();
+	int getGainSlotCount() const;
+	/**
+	 * returns the gains setTarget would switch to for a target, without
+	 * switching to them, or the current gains if there's no schedule
+	 */
+	Gains getScheduledGains(float target);
+	
 	/**
 	 * get the current proportional coefficient
 	 * @return the proportional coefficient
@@ -94,6 +147,19 @@ public:
 	 */
 	float getD() const;
 	
+	/**
+	 * sets the feed-forward coefficient, which subclasses may use in
+	 * getFeedForwardOutput however suits them.  The feed-forward output is
+	 * recalculated for the current target.
+	 * @param f the new feed-forward coefficient
+	 */
+	void setF(float f);
+	/**
+	 * get the current feed-forward coefficient
+	 * @return the feed-forward coefficient
+	 */
+	float getF() const;
+	
 	/**
 	 * configures the PIDManager to clear the accumulated error for the I term every
 	 * time the PIDManager is reanabled or the target is changed
@@ -108,9 +174,10 @@ public:
 	void clearAccumulatedError();
 
 	/**
-	 * sets the absolute range around the target in which the integral term isn't used
-	 * and the accumulated error isn't updated.  To disable this feature, set the range
-	 * to 0.0.
+	 * sets the absolute range around the target outside of which the accumulated
+	 * error isn't updated, so that the integral term only builds up close to the
+	 * target, and holds steady during large moves.  To disable this feature, set
+	 * the range to 0.0.
 	 * @param range absolute range
 	 */
 	void setAbsoluteIZone(float range);
@@ -124,6 +191,50 @@ public:
 	 */
 	void limitAccumulatedError(float min, float max);
 	
+	/**
+	 * smooths the derivative term with a first order low pass filter, so that
+	 * noise from the sensor isn't amplified into the output
+	 *
+	 * defaults to 0.0, which leaves the derivative unfiltered
+	 * @param time_constant the time constant of the filter in seconds
+	 */
+	void setDerivativeFilter(float time_constant);
+	
+	/**
+	 * sets how much of the target the proportional and derivative terms see
+	 *
+	 * The proportional term acts on proportional_weight * target - input, and
+	 * the derivative term on the rate of change of derivative_weight * target -
+	 * input.  The integral term always sees the whole error, so the input
+	 * still settles on the target.  Weights below 1.0 soften the response to
+	 * a change of target without changing the response to a disturbance.
+	 *
+	 * defaults to 1.0 and 0.0, so that changing the target doesn't kick the
+	 * derivative term
+	 * @param proportional_weight the weight of the target in the proportional term
+	 * @param derivative_weight   the weight of the target in the derivative term
+	 */
+	void setTargetWeights(float proportional_weight, float derivative_weight);
+	
+	/**
+	 * limits the output, including the feed-forward, to the range the
+	 * mechanism can actually use, and unwinds the accumulated error by back
+	 * calculation while it's limited
+	 *
+	 * While the output is out of range the integral term is pulled back
+	 * towards the part of it that fits, over tracking_time seconds, so that it
+	 * doesn't wind up while the mechanism is saturated and overshoot once it
+	 * isn't.  The pid_output given to usePIDOutput is limited too.
+	 *
+	 * To disable this feature, set the minimum equal to or greater than the
+	 * maximum.
+	 * @param min_output    the lowest output the mechanism can use
+	 * @param max_output    the highest output the mechanism can use
+	 * @param tracking_time the seconds over which the integral term is pulled
+	 *                      back; shorter unwinds faster
+	 */
+	void setBackCalculation(float min_output, float max_output, float tracking_time);
+	
 	/**
 	 * prevents the PIDManager from commencing any more calculations
 	 *
@@ -155,7 +266,7 @@ public:
 	float getLastOutput() const;
 
 protected:
-	PIDManager(float p, float i, float d);
+	PIDManager(float p, float i, float d, float f = 0.0);
 	
 	virtual float returnPIDInput() = 0;
 	/**
@@ -184,30 +295,66 @@ protected:
 	virtual float getFeedForwardOutput(float new_target);
 	
 private:
+	/**
+	 * switches to new gains
+	 * must be called with process_mutex locked
+	 */
+	void applyGains(const Gains& gains);
+	/**
+	 * interpolates the gain schedule at a target, there must be at least one slot
+	 * must be called with process_mutex locked
+	 */
+	Gains interpolateGains(float target) const;
+	/**
+	 * keeps the integral term within the limits on the accumulated error, at
+	 * the current integral coefficient, if it has any
+	 * must be called with process_mutex locked
+	 */
+	void clampIntegral();
+	
 	bool enabled;
 	float target;
 	
 	float p;
 	float i;
 	float d;
+	float f;
 	
 	float last_input;
 	float last_output;
 	float feed_forward_output;
 	
 	float last_error;
-	float accumulated_error;
+	float integral; // the output of the integral term, i * accumulated error
 	bool clear_accumulated_error;
 	
 	float max_accumulated_error;
 	float min_accumulated_error;
 	float i_zone;
 	
+	float derivative_time_constant;
+	float filtered_derivative;
+	
+	float proportional_weight;
+	float derivative_weight;
+	float last_target;
+	
+	float min_output;
+	float max_output;
+	float tracking_time;
+	
+	float slot_points[MAX_GAIN_SLOTS];
+	Gains slot_gains[MAX_GAIN_SLOTS];
+	int slot_count;
+	
 	nanoseconds last_timestamp;
 
 	mutex enable_mutex;
 	mutex process_mutex;
 	mutex user_mutex;
+	
+	// drives the output directly while it measures the system
+	friend class PIDAutotuner;
 };
 }
 
@@ -0,0 +1,390 @@
+#include <ED/PoseEKF.hpp>
+#include <ED/Utils.hpp>
+
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+namespace ED
+{
+	const float DEGREES_TO_RADIANS = M_PI / 180.0;
+
+	// LIDAR readings that hit a wall at more than 60 degrees from straight on
+	// mostly measure whatever was next to the wall, so they aren't used
+	const float MIN_WALL_INCIDENCE = 0.5;
+
+	PoseEKF::PoseEKF(const Config& config) :
+		config(config),
+		state(),
+		covariance(),
+		newest(0),
+		count(0)
+	{
+		reset(0.0, 0.0, 0.0, 0.0);
+	}
+
+	void PoseEKF::reset(double timestamp, float x, float y, float heading)
+	{
+		state.fill(0.0);
+		state(X, 0) = x;
+		state(Y, 0) = y;
+		state(HEADING, 0) = heading * DEGREES_TO_RADIANS;
+
+		// the starting pose is known to within a few centimeters and a degree or so,
+		// and the robot is known to be at rest
+		covariance.fill(0.0);
+		covariance(X, X) = 4.0;
+		covariance(Y, Y) = 4.0;
+		covariance(HEADING, HEADING) = DEGREES_TO_RADIANS * DEGREES_TO_RADIANS;
+		covariance(SPEED, SPEED) = 1.0;
+		covariance(TURN_RATE, TURN_RATE) = 0.001;
+		covariance(ACCELERATION, ACCELERATION) = 1.0;
+
+		newest = 0;
+		count = 1;
+		history[newest].timestamp = timestamp;
+		for (int i = 0; i < MEASUREMENT_TYPES; ++i) {
+			history[newest].has_measurement[i] = false;
+		}
+		commit();
+	}
+
+	void PoseEKF::predict(double timestamp)
+	{
+		double dt = timestamp - history[newest].timestamp;
+		if (dt <= 0.0) {
+			// nothing to do; more measurements will just be added to the current step
+			return;
+		}
+
+		commit();
+		propagate(dt);
+
+		newest = (newest + 1) % HISTORY_LENGTH;
+		if (count < HISTORY_LENGTH) {
+			++count;
+		}
+		history[newest].timestamp = timestamp;
+		for (int i = 0; i < MEASUREMENT_TYPES; ++i) {
+			history[newest].has_measurement[i] = false;
+		}
+	}
+
+	void PoseEKF::correctSpeed(float speed)
+	{
+		apply(SPEED_MEASUREMENT, speed, false);
+		history[newest].has_measurement[SPEED_MEASUREMENT] = true;
+		history[newest].measurement[SPEED_MEASUREMENT] = speed;
+	}
+
+	void PoseEKF::correctTurnRate(float turn_rate)
+	{
+		apply(TURN_RATE_MEASUREMENT, turn_rate, false);
+		history[newest].has_measurement[TURN_RATE_MEASUREMENT] = true;
+		history[newest].measurement[TURN_RATE_MEASUREMENT] = turn_rate;
+	}
+
+	void PoseEKF::correctAcceleration(float acceleration)
+	{
+		apply(ACCELERATION_MEASUREMENT, acceleration, false);
+		history[newest].has_measurement[ACCELERATION_MEASUREMENT] = true;
+		history[newest].measurement[ACCELERATION_MEASUREMENT] = acceleration;
+	}
+
+	bool PoseEKF::correctLidarRange(double timestamp, float range)
+	{
+		return correctLate(LIDAR_MEASUREMENT, timestamp, range);
+	}
+
+	bool PoseEKF::correctGoalBearing(double timestamp, float bearing)
+	{
+		return correctLate(BEARING_MEASUREMENT, timestamp, bearing);
+	}
+
+	bool PoseEKF::correctGoalRange(double timestamp, float range)
+	{
+		return correctLate(GOAL_RANGE_MEASUREMENT, timestamp, range);
+	}
+
+	double PoseEKF::getTimestamp() const
+	{
+		return history[newest].timestamp;
+	}
+
+	float PoseEKF::getX() const
+	{
+		return state(X, 0);
+	}
+
+	float PoseEKF::getY() const
+	{
+		return state(Y, 0);
+	}
+
+	float PoseEKF::getHeading() const
+	{
+		return state(HEADING, 0) / DEGREES_TO_RADIANS;
+	}
+
+	float PoseEKF::getSpeed() const
+	{
+		return state(SPEED, 0);
+	}
+
+	float PoseEKF::getTurnRate() const
+	{
+		return state(TURN_RATE, 0) / DEGREES_TO_RADIANS;
+	}
+
+	float PoseEKF::getAcceleration() const
+	{
+		return state(ACCELERATION, 0);
+	}
+
+	float PoseEKF::getVariance(int index) const
+	{
+		return covariance(index, index);
+	}
+
+	void PoseEKF::propagate(double dt)
+	{
+		float heading = state(HEADING, 0);
+		float speed = state(SPEED, 0);
+		float cos_heading = cos(heading);
+		float sin_heading = sin(heading);
+
+		// jacobian of the motion model, taken before the state is updated
+		Matrix<STATES, STATES> jacobian = Matrix<STATES, STATES>::identity();
+		jacobian(X, HEADING) = -speed * sin_heading * dt;
+		jacobian(X, SPEED) = cos_heading * dt;
+		jacobian(Y, HEADING) = speed * cos_heading * dt;
+		jacobian(Y, SPEED) = sin_heading * dt;
+		jacobian(HEADING, TURN_RATE) = dt;
+		jacobian(SPEED, ACCELERATION) = dt;
+
+		state(X, 0) += speed * cos_heading * dt;
+		state(Y, 0) += speed * sin_heading * dt;
+		state(HEADING, 0) += state(TURN_RATE, 0) * dt;
+		state(SPEED, 0) += state(ACCELERATION, 0) * dt;
+
+		covariance = jacobian * covariance * jacobian.transpose();
+		covariance(X, X) += config.position_noise * dt;
+		covariance(Y, Y) += config.position_noise * dt;
+		covariance(HEADING, HEADING) += config.heading_noise * DEGREES_TO_RADIANS * DEGREES_TO_RADIANS * dt;
+		covariance(SPEED, SPEED) += config.speed_noise * dt;
+		covariance(TURN_RATE, TURN_RATE) += config.turn_rate_noise * DEGREES_TO_RADIANS * DEGREES_TO_RADIANS * dt;
+		covariance(ACCELERATION, ACCELERATION) += config.acceleration_noise * dt;
+	}
+
+	bool PoseEKF::apply(MeasurementType type, float value, bool gate)
+	{
+		// every measurement is a scalar, so the update only needs the
+		// predicted value, one row of the jacobian, and the noise
+		float predicted = 0.0;
+		float noise = 0.0;
+		Matrix<1, STATES> jacobian;
+
+		float heading = state(HEADING, 0);
+		float cos_heading = cos(heading);
+		float sin_heading = sin(heading);
+		float goal_dx = config.goal_x - state(X, 0);
+		float goal_dy = config.goal_y - state(Y, 0);
+		float goal_dist_sq = goal_dx * goal_dx + goal_dy * goal_dy;
+		float goal_dist = sqrt(goal_dist_sq);
+		bool angular = false;
+
+		switch (type) {
+		case SPEED_MEASUREMENT:
+			predicted = state(SPEED, 0);
+			jacobian(0, SPEED) = 1.0;
+			noise = config.speed_measurement_noise;
+			break;
+
+		case TURN_RATE_MEASUREMENT:
+			value *= DEGREES_TO_RADIANS;
+			predicted = state(TURN_RATE, 0);
+			jacobian(0, TURN_RATE) = 1.0;
+			noise = config.turn_rate_measurement_noise * DEGREES_TO_RADIANS;
+			break;
+
+		case ACCELERATION_MEASUREMENT:
+			predicted = state(ACCELERATION, 0);
+			jacobian(0, ACCELERATION) = 1.0;
+			noise = config.acceleration_measurement_noise;
+			break;
+
+		case LIDAR_MEASUREMENT: {
+			float lidar_x = state(X, 0) + config.lidar_forward_offset * cos_heading;
+			float lidar_y = state(Y, 0) + config.lidar_forward_offset * sin_heading;
+
+			// find the closest wall in front of the LIDAR, which is the one it should see
+			int wall = -1;
+			float incidence = 0.0;
+			float distance_to_plane = 0.0;
+			for (int i = 0; i < config.wall_count; ++i) {
+				const Wall& w = config.walls[i];
+				float s = w.normal_x * cos_heading + w.normal_y * sin_heading;
+				float n = w.offset - (w.normal_x * lidar_x + w.normal_y * lidar_y);
+				if (fabs(s) < MIN_WALL_INCIDENCE || n / s <= 0.0) {
+					continue;
+				}
+				if (wall < 0 || n / s < predicted) {
+					wall = i;
+					incidence = s;
+					distance_to_plane = n;
+					predicted = n / s;
+				}
+			}
+			if (wall < 0) {
+				return false;
+			}
+
+			const Wall& w = config.walls[wall];
+			float d_incidence = -w.normal_x * sin_heading + w.normal_y * cos_heading;
+			float d_distance = config.lidar_forward_offset * (w.normal_x * sin_heading - w.normal_y * cos_heading);
+			jacobian(0, X) = -w.normal_x / incidence;
+			jacobian(0, Y) = -w.normal_y / incidence;
+			jacobian(0, HEADING) = (d_distance * incidence - distance_to_plane * d_incidence) / (incidence * incidence);
+			noise = config.lidar_measurement_noise;
+			break;
+		}
+
+		case BEARING_MEASUREMENT:
+			if (goal_dist_sq < 1.0) {
+				return false;
+			}
+			value *= DEGREES_TO_RADIANS;
+			predicted = wrap(atan2(goal_dy, goal_dx) - heading, -M_PI, M_PI);
+			jacobian(0, X) = goal_dy / goal_dist_sq;
+			jacobian(0, Y) = -goal_dx / goal_dist_sq;
+			jacobian(0, HEADING) = -1.0;
+			noise = config.bearing_measurement_noise * DEGREES_TO_RADIANS;
+			angular = true;
+			break;
+
+		case GOAL_RANGE_MEASUREMENT:
+			if (goal_dist < 1.0) {
+				return false;
+			}
+			predicted = goal_dist;
+			jacobian(0, X) = -goal_dx / goal_dist;
+			jacobian(0, Y) = -goal_dy / goal_dist;
+			noise = config.goal_range_measurement_noise;
+			break;
+
+		case MEASUREMENT_TYPES:
+			return false;
+		}
+
+		float innovation = value - predicted;
+		if (angular) {
+			innovation = wrap(innovation, -M_PI, M_PI);
+		}
+
+		// P * H^T is a column, so compute it once and reuse it for the gain
+		Vector<STATES> covariance_jacobian = covariance * jacobian.transpose();
+		float innovation_variance = noise * noise;
+		for (int i = 0; i < STATES; ++i) {
+			innovation_variance += jacobian(0, i) * covariance_jacobian(i, 0);
+		}
+		if (innovation_variance <= 0.0) {
+			return false;
+		}
+
+		if (gate && innovation * innovation > config.outlier_gate * config.outlier_gate * innovation_variance) {
+			return false;
+		}
+
+		for (int r = 0; r < STATES; ++r) {
+			float gain = covariance_jacobian(r, 0) / innovation_variance;
+			state(r, 0) += gain * innovation;
+		}
+
+		// P = P - K * H * P, where H * P is the transpose of P * H^T because P is symmetric
+		for (int r = 0; r < STATES; ++r) {
+			for (int c = 0; c <= r; ++c) {
+				float updated = covariance(r, c) - covariance_jacobian(r, 0) * covariance_jacobian(c, 0) / innovation_variance;
+				covariance(r, c) = updated;
+				covariance(c, r) = updated;
+			}
+		}
+
+		return true;
+	}
+
+	bool PoseEKF::correctLate(MeasurementType type, double timestamp, float value)
+	{
+		int step = findStep(timestamp);
+		if (step < 0) {
+			return false; // older than the history
+		}
+
+		if (step == newest) {
+			bool used = apply(type, value, true);
+			if (used) {
+				history[newest].has_measurement[type] = true;
+				history[newest].measurement[type] = value;
+			}
+			return used;
+		}
+
+		int oldest = (newest - count + 1 + HISTORY_LENGTH) % HISTORY_LENGTH;
+		if (step == oldest) {
+			return false; // there's no earlier estimate to replay from
+		}
+
+		commit();
+
+		// rewind to the end of the step before the measurement, then replay
+		// every step from there, including the new measurement along the way
+		int previous = (step - 1 + HISTORY_LENGTH) % HISTORY_LENGTH;
+		state = history[previous].state;
+		covariance = history[previous].covariance;
+
+		bool used = false;
+		int index = step;
+		while (true) {
+			Step& current = history[index];
+			propagate(current.timestamp - history[previous].timestamp);
+			for (int i = 0; i < MEASUREMENT_TYPES; ++i) {
+				if (current.has_measurement[i]) {
+					apply((MeasurementType) i, current.measurement[i], false);
+				}
+			}
+			if (index == step) {
+				used = apply(type, value, true);
+				if (used) {
+					current.has_measurement[type] = true;
+					current.measurement[type] = value;
+				}
+			}
+			current.state = state;
+			current.covariance = covariance;
+
+			if (index == newest) {
+				break;
+			}
+			previous = index;
+			index = (index + 1) % HISTORY_LENGTH;
+		}
+
+		return used;
+	}
+
+	void PoseEKF::commit()
+	{
+		history[newest].state = state;
+		history[newest].covariance = covariance;
+	}
+
+	int PoseEKF::findStep(double timestamp) const
+	{
+		for (int i = 0; i < count; ++i) {
+			int index = (newest - i + HISTORY_LENGTH) % HISTORY_LENGTH;
+			if (history[index].timestamp <= timestamp) {
+				return index;
+			}
+		}
+		return -1;
+	}
+}
@@ -0,0 +1,166 @@
+#ifndef SRC_ED_POSEEKF_HPP_
+#define SRC_ED_POSEEKF_HPP_
+
+#include <ED/Matrix.hpp>
+
+namespace ED
+{
+/**
+ * An extended Kalman filter that estimates the position, heading, speed, turn
+ * rate and acceleration of a tank drive robot.
+ *
+ * Units follow the rest of the code: centimeters, seconds and degrees.  x
+ * points downfield, y points to the right, and headings are clockwise
+ * positive like the navX, so that moving forward at heading h moves the
+ * robot by (cos h, sin h).
+ *
+ * Every call to predict() starts a new step, and the measurements that
+ * arrive every tick (encoder speed, gyro rate, accelerometer) are applied to
+ * the current step.  Measurements that arrive late, like LIDAR ranges and
+ * camera bearings, are given the time at which they were captured.  They are
+ * inserted into the step at that time, and every step after it is replayed,
+ * so a late measurement corrects the past and not the present.
+ *
+ * All storage is inside the object and the filter never allocates.
+ * Measurements are applied one at a time, so no matrix is ever inverted.
+ */
+class PoseEKF
+{
+public:
+	static const int STATES = 6;
+	static const int MAX_WALLS = 8;
+	static const int HISTORY_LENGTH = 100;
+
+	/**
+	 * A straight wall on the field, made of all points p for which
+	 * normal_x * p.x + normal_y * p.y = offset
+	 */
+	struct Wall {
+		float normal_x;
+		float normal_y;
+		float offset;
+	};
+
+	struct Config {
+		// process noise, as variance gained per second
+		float position_noise;
+		float heading_noise;
+		float speed_noise;
+		float turn_rate_noise;
+		float acceleration_noise;
+
+		// measurement noise, as standard deviations
+		float speed_measurement_noise; // cm/s
+		float turn_rate_measurement_noise; // deg/s
+		float acceleration_measurement_noise; // cm/s^2
+		float lidar_measurement_noise; // cm
+		float bearing_measurement_noise; // degrees
+		float goal_range_measurement_noise; // cm
+
+		/*
+		 * late measurements whose error is more than this many standard
+		 * deviations from the estimate are thrown away, which keeps a robot
+		 * or ball in front of the LIDAR from dragging the estimate
+		 */
+		float outlier_gate;
+
+		float lidar_forward_offset; // distance from the center of the robot to the LIDAR
+
+		float goal_x;
+		float goal_y;
+
+		Wall walls[MAX_WALLS];
+		int wall_count;
+	};
+
+	PoseEKF(const Config& config);
+
+	/**
+	 * Forgets all history and restarts the filter at a known pose with
+	 * the robot at rest
+	 */
+	void reset(double timestamp, float x, float y, float heading);
+
+	/**
+	 * Moves the estimate forward to the given time and starts a new step
+	 */
+	void predict(double timestamp);
+
+	/**
+	 * The per-tick measurements, applied to the current step
+	 */
+	void correctSpeed(float speed);
+	void correctTurnRate(float turn_rate);
+	void correctAcceleration(float acceleration);
+
+	/**
+	 * Late measurements.  Each returns false if the measurement was thrown
+	 * away, either because it is older than the history, it didn't hit a
+	 * known wall, or it failed the outlier gate.
+	 */
+	bool correctLidarRange(double timestamp, float range);
+	bool correctGoalBearing(double timestamp, float bearing);
+	bool correctGoalRange(double timestamp, float range);
+
+	double getTimestamp() const;
+	float getX() const;
+	float getY() const;
+	float getHeading() const;
+	float getSpeed() const;
+	float getTurnRate() const;
+	float getAcceleration() const;
+
+	/**
+	 * Returns the variance of one of the state variables, in the internal
+	 * units (radians for heading and turn rate)
+	 */
+	float getVariance(int state) const;
+
+private:
+	enum StateIndex {
+		X,
+		Y,
+		HEADING, // radians
+		SPEED,
+		TURN_RATE, // radians per second
+		ACCELERATION
+	};
+
+	enum MeasurementType {
+		SPEED_MEASUREMENT,
+		TURN_RATE_MEASUREMENT,
+		ACCELERATION_MEASUREMENT,
+		LIDAR_MEASUREMENT,
+		BEARING_MEASUREMENT,
+		GOAL_RANGE_MEASUREMENT,
+		MEASUREMENT_TYPES
+	};
+
+	struct Step {
+		double timestamp;
+		bool has_measurement[MEASUREMENT_TYPES];
+		float measurement[MEASUREMENT_TYPES];
+
+		// estimate after every measurement in this step was applied
+		Vector<STATES> state;
+		Matrix<STATES, STATES> covariance;
+	};
+
+	Config config;
+
+	Vector<STATES> state;
+	Matrix<STATES, STATES> covariance;
+
+	Step history[HISTORY_LENGTH];
+	int newest;
+	int count;
+
+	void propagate(double dt);
+	bool apply(MeasurementType type, float value, bool gate);
+	bool correctLate(MeasurementType type, double timestamp, float value);
+	void commit();
+	int findStep(double timestamp) const;
+};
+}
+
+#endif /* SRC_ED_POSEEKF_HPP_ */
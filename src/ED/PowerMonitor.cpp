@@ -0,0 +1,81 @@
+#include <ED/PowerMonitor.hpp>
+#include <WPILib.h>
+
+namespace ED
+{
+	PowerMonitor::PowerMonitor(uint8_t module, double period) :
+		lock(),
+		published_total_current(0.0),
+		published_voltage(0.0),
+		published_timestamp(0.0)
+	{
+		for (int i = 0; i < CHANNELS; ++i) {
+			published_currents[i].store(0.0, std::memory_order_relaxed);
+		}
+
+		pdp = new PowerDistributionPanel(module);
+		notifier = new Notifier(&PowerMonitor::sample, this);
+		notifier->StartPeriodic(period);
+	}
+
+	PowerMonitor::~PowerMonitor()
+	{
+		notifier->Stop();
+		delete notifier;
+		delete pdp;
+	}
+
+	PowerMonitor::Snapshot PowerMonitor::getSnapshot() const
+	{
+		Snapshot snapshot;
+		lock.read([&]() {
+			for (int i = 0; i < CHANNELS; ++i) {
+				snapshot.currents[i] = published_currents[i].load(std::memory_order_relaxed);
+			}
+			snapshot.total_current = published_total_current.load(std::memory_order_relaxed);
+			snapshot.voltage = published_voltage.load(std::memory_order_relaxed);
+			snapshot.timestamp = published_timestamp.load(std::memory_order_relaxed);
+		});
+		return snapshot;
+	}
+
+	float PowerMonitor::getCurrent(int channel) const
+	{
+		if (channel < 0 || channel >= CHANNELS) {
+			return 0.0;
+		}
+		return published_currents[channel].load(std::memory_order_relaxed);
+	}
+
+	float PowerMonitor::getTotalCurrent() const
+	{
+		return published_total_current.load(std::memory_order_relaxed);
+	}
+
+	float PowerMonitor::getVoltage() const
+	{
+		return published_voltage.load(std::memory_order_relaxed);
+	}
+
+	void PowerMonitor::sample()
+	{
+		// read everything before publishing, so the CAN reads happen outside the
+		// sequence lock and readers never spin on them
+		float currents[CHANNELS];
+		for (int i = 0; i < CHANNELS; ++i) {
+			currents[i] = pdp->GetCurrent(i);
+		}
+		float total_current = pdp->GetTotalCurrent();
+		float voltage = pdp->GetVoltage();
+		double timestamp = Timer::GetFPGATimestamp();
+
+		lock.write([&]() {
+			for (int i = 0; i < CHANNELS; ++i) {
+				published_currents[i].store(currents[i], std::memory_order_relaxed);
+			}
+			published_total_current.store(total_current, std::memory_order_relaxed);
+			published_voltage.store(voltage, std::memory_order_relaxed);
+			published_timestamp.store(timestamp, std::memory_order_relaxed);
+		});
+	}
+}
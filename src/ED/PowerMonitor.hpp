@@ -0,0 +1,67 @@
+#ifndef SRC_ED_POWERMONITOR_HPP_
+#define SRC_ED_POWERMONITOR_HPP_
+
+#include <atomic>
+#include <stdint.h>
+#include <ED/SequenceLock.hpp>
+
+class Notifier;
+class PowerDistributionPanel;
+
+namespace ED
+{
+/**
+ * Reads every channel of the Power Distribution Panel on a thread of its own.
+ *
+ * Each read from the PDP is a message over CAN, so reading all sixteen
+ * channels from the main loop would hold it up.  Instead, a thread reads
+ * every channel, the total current and the battery voltage together at a
+ * fixed rate, and publishes them as one snapshot through a sequence lock,
+ * which can then be read from any thread without waiting.
+ */
+class PowerMonitor
+{
+public:
+	static const int CHANNELS = 16;
+
+	struct Snapshot {
+		float currents[CHANNELS]; // amperes
+		float total_current; // amperes
+		float voltage; // volts
+		double timestamp; // FPGA time of the reading, 0.0 before the first
+	};
+
+	/**
+	 * @param module the CAN id of the PDP
+	 * @param period the seconds between readings
+	 */
+	PowerMonitor(uint8_t module, double period);
+	~PowerMonitor();
+
+	/**
+	 * @return the latest reading of every channel, all taken together
+	 */
+	Snapshot getSnapshot() const;
+
+	float getCurrent(int channel) const;
+	float getTotalCurrent() const;
+	float getVoltage() const;
+
+private:
+	void sample();
+
+	PowerDistributionPanel* pdp;
+	Notifier* notifier;
+
+	SequenceLock lock;
+	std::atomic<float> published_currents[CHANNELS];
+	std::atomic<float> published_total_current;
+	std::atomic<float> published_voltage;
+	std::atomic<double> published_timestamp;
+
+	PowerMonitor(const PowerMonitor&) = delete;
+	PowerMonitor& operator=(const PowerMonitor&) = delete;
+};
+}
+
+#endif /* SRC_ED_POWERMONITOR_HPP_ */
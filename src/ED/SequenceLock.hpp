@@ -0,0 +1,70 @@
+#ifndef SRC_ED_SEQUENCELOCK_HPP_
+#define SRC_ED_SEQUENCELOCK_HPP_
+
+#include <atomic>
+#include <stdint.h>
+
+namespace ED
+{
+/**
+ * Publishes a group of values from one writer thread to any number of reader
+ * threads, so that readers always see the whole group from one write.
+ *
+ * The writer never waits, and readers never block the writer: a reader just
+ * tries again if a write happened while it was reading.  The values
+ * themselves must be std::atomic, read and written with
+ * std::memory_order_relaxed inside read and write, so that a torn read is
+ * never undefined behavior, only retried.
+ *
+ * There must only ever be one writer at a time.
+ */
+class SequenceLock
+{
+public:
+	SequenceLock() :
+		sequence(0)
+	{
+	}
+
+	/**
+	 * calls store, which stores every value, as one write
+	 */
+	template<class Function>
+	void write(Function store)
+	{
+		// odd sequence numbers tell readers that a write is in progress
+		uint32_t seq = sequence.load(std::memory_order_relaxed);
+		sequence.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		store();
+
+		sequence.store(seq + 2, std::memory_order_release);
+	}
+
+	/**
+	 * calls load, which loads every value, until it gets them all from the same
+	 * write
+	 */
+	template<class Function>
+	void read(Function load) const
+	{
+		uint32_t before;
+		uint32_t after;
+		do {
+			before = sequence.load(std::memory_order_acquire);
+			load();
+			std::atomic_thread_fence(std::memory_order_acquire);
+			after = sequence.load(std::memory_order_relaxed);
+		} while ((before & 1) != 0 || before != after);
+	}
+
+private:
+	std::atomic<uint32_t> sequence;
+
+	SequenceLock(const SequenceLock&) = delete;
+	SequenceLock& operator=(const SequenceLock&) = delete;
+};
+}
+
+#endif /* SRC_ED_SEQUENCELOCK_HPP_ */
@@ -0,0 +1,51 @@
+#ifndef SRC_ED_STATICPOOL_HPP_
+#define SRC_ED_STATICPOOL_HPP_
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ED
+{
+/**
+ * Static storage for up to N objects of type T, constructed one at a time.
+ *
+ * WPILib objects can't be made until the HAL is up, which is why the
+ * subsystems make theirs in initialize rather than declaring them as globals.
+ * A pool keeps that, but takes the memory from static storage instead of the
+ * heap, so that none is allocated once the robot is running.  Objects live
+ * until the program ends.
+ *
+ * A pool must itself have static storage duration: it has no constructor, so
+ * that it's zeroed before any static initialization that might make objects
+ * from it runs.
+ */
+template<class T, int N>
+class StaticPool
+{
+public:
+	/**
+	 * constructs an object in the pool
+	 * @return the object, or nullptr if the pool is full
+	 */
+	template<class... Args>
+	T* make(Args&&... args)
+	{
+		if (count >= N) {
+			return nullptr;
+		}
+		return new (&storage[count++]) T(std::forward<Args>(args)...);
+	}
+
+	int getCount() const
+	{
+		return count;
+	}
+
+private:
+	typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[N];
+	int count;
+};
+}
+
+#endif /* SRC_ED_STATICPOOL_HPP_ */
@@ -0,0 +1,149 @@
+#include <ED/Tachometer.hpp>
+#include <WPILib.h>
+
+namespace ED
+{
+	Tachometer::Tachometer(uint32_t channel, int pulses_per_revolution, int filter_length, float smoothing, double stall_time, double poll_period) :
+		pulses_per_revolution(pulses_per_revolution),
+		filter_length(filter_length < 1 ? 1 : (filter_length > MAX_FILTER_LENGTH ? MAX_FILTER_LENGTH : filter_length)),
+		smoothing(smoothing),
+		stall_time(stall_time),
+		last_count(0),
+		last_edge_timestamp(0.0),
+		stalled(true),
+		period_count(0),
+		next_period(0),
+		filtered_rpm(0.0),
+		lock(),
+		published_rpm(0.0),
+		published_timestamp(0.0),
+		published_stalled(true)
+	{
+		counter = new Counter(channel);
+		counter->SetSamplesToAverage(1); // the median filter does the averaging
+		counter->SetMaxPeriod(stall_time);
+		last_count = counter->Get();
+
+		notifier = new Notifier(&Tachometer::poll, this);
+		notifier->StartPeriodic(poll_period);
+	}
+
+	Tachometer::~Tachometer()
+	{
+		notifier->Stop();
+		delete notifier;
+		delete counter;
+	}
+
+	float Tachometer::getRPM() const
+	{
+		float rpm;
+		double timestamp;
+		bool stalled;
+		getState(rpm, timestamp, stalled);
+		return rpm;
+	}
+
+	double Tachometer::getAge() const
+	{
+		float rpm;
+		double timestamp;
+		bool stalled;
+		getState(rpm, timestamp, stalled);
+		return Timer::GetFPGATimestamp() - timestamp;
+	}
+
+	bool Tachometer::isStalled() const
+	{
+		float rpm;
+		double timestamp;
+		bool stalled;
+		getState(rpm, timestamp, stalled);
+		return stalled;
+	}
+
+	void Tachometer::getState(float& rpm, double& timestamp, bool& stalled) const
+	{
+		lock.read([&]() {
+			rpm = published_rpm.load(std::memory_order_relaxed);
+			timestamp = published_timestamp.load(std::memory_order_relaxed);
+			stalled = published_stalled.load(std::memory_order_relaxed);
+		});
+	}
+
+	void Tachometer::poll()
+	{
+		int count = counter->Get();
+		double now = Timer::GetFPGATimestamp();
+
+		if (count != last_count) {
+			last_count = count;
+			last_edge_timestamp = now;
+
+			// the period of the first edge after a stall covers the stall, not a
+			// revolution, so it's skipped
+			double period = counter->GetPeriod();
+			if (stalled) {
+				stalled = false;
+			}
+			else if (period > 0.0 && period < stall_time) {
+				periods[next_period] = period;
+				next_period = (next_period + 1) % filter_length;
+				if (period_count < filter_length) {
+					++period_count;
+				}
+
+				// insertion sort is quickest for this few periods
+				float sorted[MAX_FILTER_LENGTH];
+				for (int i = 0; i < period_count; ++i) {
+					int j = i;
+					for (; j > 0 && sorted[j - 1] > periods[i]; --j) {
+						sorted[j] = sorted[j - 1];
+					}
+					sorted[j] = periods[i];
+				}
+				float median = sorted[period_count / 2];
+
+				float rpm = 60.0 / (median * pulses_per_revolution);
+				if (period_count == 1) {
+					filtered_rpm = rpm;
+				}
+				else {
+					filtered_rpm += smoothing * (rpm - filtered_rpm);
+				}
+			}
+		}
+		else if (!stalled && now - last_edge_timestamp > stall_time) {
+			stalled = true;
+			period_count = 0;
+			next_period = 0;
+			filtered_rpm = 0.0;
+		}
+
+		if (stalled || period_count == 0) {
+			publish(0.0, now, stalled);
+			return;
+		}
+
+		// a wheel that hasn't reached its next edge yet is going no faster than
+		// one that would reach it right now
+		float rpm = filtered_rpm;
+		double since_edge = now - last_edge_timestamp;
+		if (since_edge > 0.0) {
+			float slowest_rpm = 60.0 / (since_edge * pulses_per_revolution);
+			if (slowest_rpm < rpm) {
+				rpm = slowest_rpm;
+			}
+		}
+		publish(rpm, last_edge_timestamp, false);
+	}
+
+	void Tachometer::publish(float rpm, double timestamp, bool stalled)
+	{
+		lock.write([&]() {
+			published_rpm.store(rpm, std::memory_order_relaxed);
+			published_timestamp.store(timestamp, std::memory_order_relaxed);
+			published_stalled.store(stalled, std::memory_order_relaxed);
+		});
+	}
+}
@@ -0,0 +1,104 @@
+#ifndef SRC_ED_TACHOMETER_HPP_
+#define SRC_ED_TACHOMETER_HPP_
+
+#include <atomic>
+#include <stdint.h>
+#include <ED/SequenceLock.hpp>
+
+class Counter;
+class Notifier;
+
+namespace ED
+{
+/**
+ * Measures the speed of a wheel from the time between pulses of a sensor on
+ * a digital input.
+ *
+ * Counting pulses over each pass of the main loop only works as well as the
+ * loop is regular, and with one pulse per revolution it takes a long time to
+ * see the wheel slow down.  Instead, the FPGA times the period between each
+ * pair of edges, and a thread checks for new edges a few times between them.
+ * Each new period goes into a median filter, which throws out the odd missed
+ * or doubled pulse, and the median is smoothed with a low pass filter.
+ *
+ * When no edge arrives for longer than the last period, the wheel must be
+ * slowing, so the speed is limited to what the time since the last edge
+ * allows.  After stall_time without an edge, the wheel is stopped.
+ *
+ * The speed is published through a sequence lock, so it can be read from any
+ * thread without waiting on the one measuring it.
+ */
+class Tachometer
+{
+public:
+	static const int MAX_FILTER_LENGTH = 15;
+
+	/**
+	 * @param channel               the digital input of the sensor
+	 * @param pulses_per_revolution the number of pulses the sensor gives
+	 *                              each revolution of the wheel
+	 * @param filter_length         the number of recent periods to take the
+	 *                              median of, up to MAX_FILTER_LENGTH
+	 * @param smoothing             the weight, from 0 to 1, given to each new
+	 *                              median by the low pass filter; 1 turns the
+	 *                              low pass filter off
+	 * @param stall_time            the seconds without an edge after which the
+	 *                              wheel is considered stopped
+	 * @param poll_period           the seconds between checks for new edges
+	 */
+	Tachometer(uint32_t channel, int pulses_per_revolution, int filter_length, float smoothing, double stall_time, double poll_period);
+	~Tachometer();
+
+	/**
+	 * @return the speed of the wheel in rotations per minute
+	 */
+	float getRPM() const;
+
+	/**
+	 * @return the seconds since the edge the speed was last measured from
+	 */
+	double getAge() const;
+
+	/**
+	 * @return whether no edge has arrived for stall_time
+	 */
+	bool isStalled() const;
+
+	/**
+	 * Reads the speed, the FPGA time of the edge it was measured from, and
+	 * whether the wheel is stalled as one consistent set
+	 */
+	void getState(float& rpm, double& timestamp, bool& stalled) const;
+
+private:
+	void poll();
+	void publish(float rpm, double timestamp, bool stalled);
+
+	Counter* counter;
+	Notifier* notifier;
+
+	const int pulses_per_revolution;
+	const int filter_length;
+	const float smoothing;
+	const double stall_time;
+
+	// only touched by the polling thread
+	int last_count;
+	double last_edge_timestamp;
+	bool stalled;
+	float periods[MAX_FILTER_LENGTH];
+	int period_count;
+	int next_period;
+	float filtered_rpm;
+
+	SequenceLock lock;
+	std::atomic<float> published_rpm;
+	std::atomic<double> published_timestamp;
+	std::atomic<bool> published_stalled;
+
+	Tachometer(const Tachometer&) = delete;
+	Tachometer& operator=(const Tachometer&) = delete;
+};
+}
+
+#endif /* SRC_ED_TACHOMETER_HPP_ */
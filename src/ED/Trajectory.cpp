@@ -0,0 +1,101 @@
+#include <ED/Trajectory.hpp>
+#include <ED/Utils.hpp>
+
+namespace ED
+{
+	Trajectory::Trajectory() :
+		storage(new Sample[MAX_SAMPLES]),
+		samples(storage),
+		capacity(MAX_SAMPLES),
+		count(0),
+		period(0.01)
+	{
+	}
+
+	Trajectory::Trajectory(const Sample* samples, int count, float period) :
+		storage(nullptr),
+		samples(samples),
+		capacity(0),
+		count(count),
+		period(period)
+	{
+	}
+
+	Trajectory::~Trajectory()
+	{
+		delete[] storage;
+	}
+
+	void Trajectory::clear(float period)
+	{
+		if (storage != nullptr) {
+			count = 0;
+			this->period = period;
+		}
+	}
+
+	bool Trajectory::add(const Sample& sample)
+	{
+		if (storage == nullptr || count >= capacity) {
+			return false;
+		}
+		storage[count++] = sample;
+		return true;
+	}
+
+	Trajectory::Sample Trajectory::sample(float time) const
+	{
+		if (count == 0) {
+			Sample empty = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+			empty.time = time;
+			return empty;
+		}
+
+		float position = time / period;
+		if (position <= 0.0) {
+			return samples[0];
+		}
+		int index = (int) position;
+		if (index >= count - 1) {
+			Sample last = samples[count - 1];
+			last.velocity = 0.0;
+			last.acceleration = 0.0;
+			return last;
+		}
+
+		const Sample& a = samples[index];
+		const Sample& b = samples[index + 1];
+		float fraction = position - index;
+
+		Sample result;
+		result.time = time;
+		result.x = a.x + (b.x - a.x) * fraction;
+		result.y = a.y + (b.y - a.y) * fraction;
+		result.heading = a.heading + (b.heading - a.heading) * fraction;
+		result.distance = a.distance + (b.distance - a.distance) * fraction;
+		result.velocity = a.velocity + (b.velocity - a.velocity) * fraction;
+		result.acceleration = a.acceleration + (b.acceleration - a.acceleration) * fraction;
+		result.curvature = a.curvature + (b.curvature - a.curvature) * fraction;
+		return result;
+	}
+
+	const Trajectory::Sample& Trajectory::getSample(int index) const
+	{
+		return samples[(int) boundsCheck(index, 0, count > 0 ? count - 1 : 0)];
+	}
+
+	int Trajectory::getCount() const
+	{
+		return count;
+	}
+
+	float Trajectory::getPeriod() const
+	{
+		return period;
+	}
+
+	float Trajectory::getDuration() const
+	{
+		return count > 0 ? samples[count - 1].time : 0.0;
+	}
+}
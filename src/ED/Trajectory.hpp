@@ -0,0 +1,85 @@
+#ifndef SRC_ED_TRAJECTORY_HPP_
+#define SRC_ED_TRAJECTORY_HPP_
+
+namespace ED
+{
+/**
+ * A path for a tank drive robot that has already been worked out in time:
+ * where the robot should be, which way it should point, and how fast it should
+ * be going, at evenly spaced moments from the start of the move.
+ *
+ * The samples are stored in a flat array, so following a trajectory is only a
+ * lookup and an interpolation.  A trajectory either owns its array, allocated
+ * once when it's created, so that it can be generated (see
+ * TrajectoryGenerator) long before it's needed, or it reads samples that
+ * belong to someone else, like a TrajectoryCache file mapped into memory.
+ *
+ * Units and directions follow Odometry: centimeters, seconds, and degrees
+ * clockwise positive, with the robot moving by (cos heading, sin heading)
+ * when it drives forward.
+ */
+class Trajectory
+{
+public:
+	static const int MAX_SAMPLES = 1500;
+
+	struct Sample {
+		float time; // seconds since the start of the trajectory
+		float x;
+		float y;
+		float heading; // degrees, continuous
+		float distance; // signed distance driven since the start
+		float velocity; // negative when driving backwards
+		float acceleration;
+		float curvature; // radians of turn per centimeter driven, positive turns clockwise
+	};
+
+	/**
+	 * Creates an empty trajectory with room for MAX_SAMPLES samples
+	 */
+	Trajectory();
+
+	/**
+	 * Creates a read-only trajectory from samples stored elsewhere, which must
+	 * outlive it
+	 */
+	Trajectory(const Sample* samples, int count, float period);
+
+	~Trajectory();
+
+	/**
+	 * Removes all samples
+	 * @param period seconds between samples
+	 */
+	void clear(float period);
+
+	/**
+	 * Appends a sample, which should be one period after the last
+	 * @return false if the trajectory is full or read-only
+	 */
+	bool add(const Sample& sample);
+
+	/**
+	 * @return the state of the robot at time seconds after the start,
+	 *         interpolated between samples and holding at the ends
+	 */
+	Sample sample(float time) const;
+
+	const Sample& getSample(int index) const;
+	int getCount() const;
+	float getPeriod() const;
+	float getDuration() const;
+
+private:
+	Sample* storage; // nullptr if read-only
+	const Sample* samples;
+	int capacity;
+	int count;
+	float period;
+
+	Trajectory(const Trajectory&) = delete;
+	Trajectory& operator=(const Trajectory&) = delete;
+};
+}
+
+#endif /* SRC_ED_TRAJECTORY_HPP_ */
@@ -0,0 +1,121 @@
+#include <ED/TrajectoryCache.hpp>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ED
+{
+	static_assert(sizeof(Trajectory::Sample) == 8 * sizeof(float), "trajectory samples must be packed to be stored in a file");
+
+	TrajectoryCache::TrajectoryCache() :
+		mapping(nullptr),
+		mapping_size(0),
+		count(0)
+	{
+	}
+
+	TrajectoryCache::~TrajectoryCache()
+	{
+		unload();
+	}
+
+	bool TrajectoryCache::load(const char* path, uint32_t checksum)
+	{
+		unload();
+
+		int file = open(path, O_RDONLY);
+		if (file < 0) {
+			return false;
+		}
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size < (off_t) sizeof(Header)) {
+			close(file);
+			return false;
+		}
+		mapping_size = status.st_size;
+		mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file); // the mapping keeps the file open
+		if (mapping == MAP_FAILED) {
+			mapping = nullptr;
+			mapping_size = 0;
+			return false;
+		}
+
+		const char* bytes = (const char*) mapping;
+		const Header* header = (const Header*) bytes;
+		if (header->magic != MAGIC || header->version != VERSION || header->checksum != checksum ||
+		    header->count > (uint32_t) MAX_TRAJECTORIES ||
+		    sizeof(Header) + header->count * sizeof(Entry) > mapping_size) {
+			unload();
+			return false;
+		}
+
+		const Entry* entries = (const Entry*) (bytes + sizeof(Header));
+		for (uint32_t i = 0; i < header->count; ++i) {
+			const Entry& entry = entries[i];
+			size_t size = (size_t) entry.sample_count * sizeof(Trajectory::Sample);
+			if (entry.offset % sizeof(float) != 0 || entry.offset > mapping_size || size > mapping_size - entry.offset ||
+			    entry.sample_count > (uint32_t) Trajectory::MAX_SAMPLES || !(entry.period > 0.0)) {
+				unload();
+				return false;
+			}
+			trajectories[count++] = new Trajectory((const Trajectory::Sample*) (bytes + entry.offset), entry.sample_count, entry.period);
+		}
+		return true;
+	}
+
+	void TrajectoryCache::unload()
+	{
+		for (int i = 0; i < count; ++i) {
+			delete trajectories[i];
+		}
+		count = 0;
+
+		if (mapping != nullptr) {
+			munmap(mapping, mapping_size);
+			mapping = nullptr;
+			mapping_size = 0;
+		}
+	}
+
+	const Trajectory* TrajectoryCache::get(int index) const
+	{
+		return index >= 0 && index < count ? trajectories[index] : nullptr;
+	}
+
+	int TrajectoryCache::getCount() const
+	{
+		return count;
+	}
+
+	bool TrajectoryCache::write(const char* path, uint32_t checksum, const Trajectory* const* trajectories, int count)
+	{
+		if (count < 0 || count > MAX_TRAJECTORIES) {
+			return false;
+		}
+		FILE* file = fopen(path, "wb");
+		if (file == nullptr) {
+			return false;
+		}
+
+		Header header = { MAGIC, VERSION, checksum, (uint32_t) count };
+		bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+		uint32_t offset = sizeof(Header) + count * sizeof(Entry);
+		for (int i = 0; i < count && ok; ++i) {
+			Entry entry = { offset, (uint32_t) trajectories[i]->getCount(), trajectories[i]->getPeriod(), 0 };
+			ok = fwrite(&entry, sizeof(entry), 1, file) == 1;
+			offset += entry.sample_count * sizeof(Trajectory::Sample);
+		}
+
+		for (int i = 0; i < count && ok; ++i) {
+			for (int j = 0; j < trajectories[i]->getCount() && ok; ++j) {
+				ok = fwrite(&trajectories[i]->getSample(j), sizeof(Trajectory::Sample), 1, file) == 1;
+			}
+		}
+
+		return fclose(file) == 0 && ok;
+	}
+}
@@ -0,0 +1,85 @@
+#ifndef SRC_ED_TRAJECTORYCACHE_HPP_
+#define SRC_ED_TRAJECTORYCACHE_HPP_
+
+#include <ED/Trajectory.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ED
+{
+/**
+ * A file of trajectories that were generated ahead of time, so that none have
+ * to be generated on the robot.
+ *
+ * The file is a header, a table with one entry per trajectory, and then the
+ * samples of every trajectory, stored exactly as they are in memory.  Loading
+ * the file maps it into memory and points a read-only Trajectory at each
+ * block of samples, so nothing is parsed or copied, and the operating system
+ * only reads the pages that are actually used.  The samples are stored in the
+ * byte order of the machine that wrote them, which is little endian for both
+ * desktops and the roboRIO.
+ *
+ * The header records a checksum of whatever the trajectories were generated
+ * from, like the waypoints and the limits.  A file with a different checksum
+ * is stale and won't load, so an out-of-date file can never drive the robot
+ * somewhere it wasn't meant to go.
+ */
+class TrajectoryCache
+{
+public:
+	static const int MAX_TRAJECTORIES = 64;
+
+	TrajectoryCache();
+	~TrajectoryCache();
+
+	/**
+	 * Maps a file made by write() into memory, unloading anything loaded before
+	 * @param  checksum the checksum the file must have been written with
+	 * @return false if the file is missing, damaged or stale
+	 */
+	bool load(const char* path, uint32_t checksum);
+	void unload();
+
+	/**
+	 * @return the trajectory at index in the order they were written, or
+	 *         nullptr if there isn't one
+	 */
+	const Trajectory* get(int index) const;
+	int getCount() const;
+
+	/**
+	 * Writes trajectories to a file that load() can read
+	 * @return false if the file couldn't be written
+	 */
+	static bool write(const char* path, uint32_t checksum, const Trajectory* const* trajectories, int count);
+
+private:
+	static const uint32_t MAGIC = 0x4a544445; // "EDTJ"
+	static const uint32_t VERSION = 1;
+
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t checksum;
+		uint32_t count;
+	};
+
+	struct Entry {
+		uint32_t offset; // bytes from the start of the file to the first sample
+		uint32_t sample_count;
+		float period;
+		uint32_t reserved;
+	};
+
+	void* mapping;
+	size_t mapping_size;
+
+	Trajectory* trajectories[MAX_TRAJECTORIES];
+	int count;
+
+	TrajectoryCache(const TrajectoryCache&) = delete;
+	TrajectoryCache& operator=(const TrajectoryCache&) = delete;
+};
+}
+
+#endif /* SRC_ED_TRAJECTORYCACHE_HPP_ */
@@ -0,0 +1,262 @@
+#include <ED/MotionProfile.hpp>
+#include <ED/TrajectoryGenerator.hpp>
+
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+namespace ED
+{
+	const int STEPS_PER_SPLINE = 200;
+
+	/*
+	 * The length of the tangents at each waypoint, relative to the distance
+	 * between the waypoints.  Longer tangents make wider, gentler turns.
+	 */
+	const float TANGENT_SCALE = 1.2;
+
+	const float MIN_CURVATURE = 0.00001; // radians per cm, straighter than this is straight
+
+	/**
+	 * Returns how long it takes to move distance when starting at velocity
+	 * and accelerating at acceleration, or 0.0 if the robot wouldn't move
+	 */
+	static float travelTime(float velocity, float acceleration, float distance)
+	{
+		if (fabs(acceleration) > 0.001) {
+			float discriminant = velocity * velocity + 2.0 * acceleration * distance;
+			return discriminant > 0.0 ? (sqrt(discriminant) - velocity) / acceleration : 0.0;
+		}
+		else if (velocity > 0.001) {
+			return distance / velocity;
+		}
+		else {
+			return 0.0;
+		}
+	}
+
+	TrajectoryGenerator::TrajectoryGenerator(const Limits& limits, float period) :
+		limits(limits),
+		period(period),
+		point_count(0)
+	{
+	}
+
+	bool TrajectoryGenerator::generateStraight(Trajectory& trajectory, const Waypoint& start, float distance)
+	{
+		MotionProfile profile;
+		profile.plan(0.0, distance, limits.max_velocity, limits.max_acceleration, limits.max_jerk);
+
+		float heading = start.heading * M_PI / 180.0;
+		trajectory.clear(period);
+		for (int i = 0; ; ++i) {
+			float time = i * period;
+			MotionProfile::State state = profile.sample(time);
+
+			Trajectory::Sample sample;
+			sample.time = time;
+			sample.x = start.x + state.position * cos(heading);
+			sample.y = start.y + state.position * sin(heading);
+			sample.heading = start.heading;
+			sample.distance = state.position;
+			sample.velocity = state.velocity;
+			sample.acceleration = state.acceleration;
+			sample.curvature = 0.0;
+			if (!trajectory.add(sample)) {
+				return false;
+			}
+
+			if (time >= profile.getDuration()) {
+				return true;
+			}
+		}
+	}
+
+	bool TrajectoryGenerator::generateSpline(Trajectory& trajectory, const Waypoint* waypoints, int waypoint_count, bool reverse)
+	{
+		if (waypoint_count < 2 || waypoint_count > MAX_WAYPOINTS) {
+			return false;
+		}
+
+		float direction = reverse ? -1.0 : 1.0;
+		point_count = 0;
+		for (int i = 0; i + 1 < waypoint_count; ++i) {
+			if (!addSpline(waypoints[i], waypoints[i + 1], direction)) {
+				return false;
+			}
+		}
+
+		limitVelocities();
+		return resample(trajectory, direction);
+	}
+
+	bool TrajectoryGenerator::addSpline(const Waypoint& start, const Waypoint& end, float direction)
+	{
+		// the path is described by the direction of travel, which is backwards
+		// from the way the robot faces when it's reversing
+		float travel_offset = direction < 0.0 ? 180.0 : 0.0;
+		float start_heading = (start.heading + travel_offset) * M_PI / 180.0;
+		float end_heading = (end.heading + travel_offset) * M_PI / 180.0;
+
+		float tangent = TANGENT_SCALE * hypot(end.x - start.x, end.y - start.y);
+		float start_dx = tangent * cos(start_heading);
+		float start_dy = tangent * sin(start_heading);
+		float end_dx = tangent * cos(end_heading);
+		float end_dy = tangent * sin(end_heading);
+
+		// the first point of every spline but the first is the last point of the one before
+		int first_step = point_count == 0 ? 0 : 1;
+		if (point_count + STEPS_PER_SPLINE + 1 - first_step > MAX_POINTS) {
+			return false;
+		}
+
+		for (int step = first_step; step <= STEPS_PER_SPLINE; ++step) {
+			float t = (float) step / STEPS_PER_SPLINE;
+			float t2 = t * t;
+			float t3 = t2 * t;
+
+			// cubic Hermite basis functions and their first two derivatives
+			float h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+			float h10 = t3 - 2.0 * t2 + t;
+			float h01 = -2.0 * t3 + 3.0 * t2;
+			float h11 = t3 - t2;
+			float d00 = 6.0 * t2 - 6.0 * t;
+			float d10 = 3.0 * t2 - 4.0 * t + 1.0;
+			float d01 = -6.0 * t2 + 6.0 * t;
+			float d11 = 3.0 * t2 - 2.0 * t;
+			float dd00 = 12.0 * t - 6.0;
+			float dd10 = 6.0 * t - 4.0;
+			float dd01 = -12.0 * t + 6.0;
+			float dd11 = 6.0 * t - 2.0;
+
+			float dx = d00 * start.x + d10 * start_dx + d01 * end.x + d11 * end_dx;
+			float dy = d00 * start.y + d10 * start_dy + d01 * end.y + d11 * end_dy;
+			float ddx = dd00 * start.x + dd10 * start_dx + dd01 * end.x + dd11 * end_dx;
+			float ddy = dd00 * start.y + dd10 * start_dy + dd01 * end.y + dd11 * end_dy;
+
+			Point& point = points[point_count];
+			point.x = h00 * start.x + h10 * start_dx + h01 * end.x + h11 * end_dx;
+			point.y = h00 * start.y + h10 * start_dy + h01 * end.y + h11 * end_dy;
+
+			// keep the heading continuous with the point before, or with the
+			// waypoint if this is the first point
+			float previous_heading = point_count == 0 ? start.heading + travel_offset : points[point_count - 1].heading;
+			float heading = atan2(dy, dx) * 180.0 / M_PI;
+			point.heading = heading + 360.0 * round((previous_heading - heading) / 360.0);
+
+			float speed = hypot(dx, dy);
+			point.curvature = speed > 0.0 ? (dx * ddy - dy * ddx) / (speed * speed * speed) : 0.0;
+
+			point.distance = point_count == 0 ? 0.0 :
+				points[point_count - 1].distance + hypot(point.x - points[point_count - 1].x, point.y - points[point_count - 1].y);
+			++point_count;
+		}
+		return true;
+	}
+
+	void TrajectoryGenerator::limitVelocities()
+	{
+		for (int i = 0; i < point_count; ++i) {
+			float curvature = fabs(points[i].curvature);
+			points[i].velocity = limits.max_velocity;
+			if (curvature > MIN_CURVATURE) {
+				points[i].velocity = fmin(points[i].velocity, sqrt(limits.max_centripetal_acceleration / curvature));
+			}
+		}
+		points[0].velocity = 0.0;
+		points[point_count - 1].velocity = 0.0;
+
+		// speeding up, then the same thing backwards for slowing down
+		for (int pass = 0; pass < 2; ++pass) {
+			int first = pass == 0 ? 1 : point_count - 2;
+			int step = pass == 0 ? 1 : -1;
+			float acceleration = 0.0;
+			for (int i = first; i >= 0 && i < point_count; i += step) {
+				const Point& previous = points[i - step];
+				float distance = fabs(points[i].distance - previous.distance);
+				if (distance <= 0.0) {
+					points[i].velocity = fmin(points[i].velocity, previous.velocity);
+					continue;
+				}
+
+				float allowed = limits.max_acceleration;
+				if (limits.max_jerk > 0.0) {
+					float time = travelTime(previous.velocity, acceleration, distance);
+					if (time <= 0.0) {
+						// from a standstill, the first piece is covered by jerk alone
+						time = cbrt(6.0 * distance / limits.max_jerk);
+					}
+					allowed = fmin(allowed, acceleration + limits.max_jerk * time);
+				}
+
+				float reachable = sqrt(previous.velocity * previous.velocity + 2.0 * allowed * distance);
+				points[i].velocity = fmin(points[i].velocity, reachable);
+				acceleration = fmax(0.0, (points[i].velocity * points[i].velocity - previous.velocity * previous.velocity) / (2.0 * distance));
+			}
+		}
+	}
+
+	bool TrajectoryGenerator::resample(Trajectory& trajectory, float direction)
+	{
+		trajectory.clear(period);
+
+		float travel_offset = direction < 0.0 ? 180.0 : 0.0;
+		int index = 0;
+		float segment_start_time = 0.0;
+		for (int i = 0; ; ++i) {
+			float time = i * period;
+
+			// find the piece of the path the robot is on at this time, where
+			// each piece is driven with a constant acceleration
+			float segment_time = 0.0;
+			while (index + 1 < point_count) {
+				float average_velocity = (points[index].velocity + points[index + 1].velocity) / 2.0;
+				float distance = points[index + 1].distance - points[index].distance;
+				if (distance > 0.0 && average_velocity <= 0.0) {
+					return false; // the limits don't let the robot move at all
+				}
+				segment_time = distance > 0.0 ? distance / average_velocity : 0.0;
+				if (time < segment_start_time + segment_time) {
+					break;
+				}
+				segment_start_time += segment_time;
+				++index;
+			}
+
+			Trajectory::Sample sample;
+			sample.time = time;
+			const Point& a = points[index];
+			if (index + 1 >= point_count) {
+				// past the end of the path
+				sample.x = a.x;
+				sample.y = a.y;
+				sample.heading = a.heading - travel_offset;
+				sample.distance = direction * a.distance;
+				sample.velocity = 0.0;
+				sample.acceleration = 0.0;
+				sample.curvature = direction * a.curvature;
+				return trajectory.add(sample);
+			}
+
+			const Point& b = points[index + 1];
+			float elapsed = time - segment_start_time;
+			float acceleration = (b.velocity - a.velocity) / segment_time;
+			float traveled = a.velocity * elapsed + acceleration * elapsed * elapsed / 2.0;
+			float fraction = traveled / (b.distance - a.distance);
+
+			sample.x = a.x + (b.x - a.x) * fraction;
+			sample.y = a.y + (b.y - a.y) * fraction;
+			sample.heading = a.heading + (b.heading - a.heading) * fraction - travel_offset;
+			sample.distance = direction * (a.distance + traveled);
+			sample.velocity = direction * (a.velocity + acceleration * elapsed);
+			sample.acceleration = direction * acceleration;
+
+			// the heading turns the same way whichever way the robot drives, so
+			// the curvature relative to the robot's own velocity flips in reverse
+			sample.curvature = direction * (a.curvature + (b.curvature - a.curvature) * fraction);
+			if (!trajectory.add(sample)) {
+				return false;
+			}
+		}
+	}
+}
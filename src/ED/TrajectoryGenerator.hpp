@@ -0,0 +1,94 @@
+#ifndef SRC_ED_TRAJECTORYGENERATOR_HPP_
+#define SRC_ED_TRAJECTORYGENERATOR_HPP_
+
+#include <ED/Trajectory.hpp>
+
+namespace ED
+{
+/**
+ * Turns a description of a move into a Trajectory.
+ *
+ * Straight moves use a MotionProfile, so they respect the velocity,
+ * acceleration and jerk limits exactly.
+ *
+ * Curved moves pass through a list of waypoints, each with a position and
+ * the heading the robot should have there.  Neighbouring waypoints are joined
+ * by cubic Hermite splines, which are chopped into short pieces.  Each piece
+ * is given the fastest speed allowed by the velocity limit and by the
+ * centripetal acceleration limit on its curvature, then a forward and a
+ * backward pass bring the speeds down until the robot can speed up and slow
+ * down between them.  Those passes also limit how quickly the acceleration
+ * may change, which approximates the jerk limit; it isn't exact, because the
+ * passes can't see a limit coming and ease off the acceleration before it.
+ *
+ * The generator keeps its working memory inside the object, so it should be
+ * created once (it's large) and reused.
+ */
+class TrajectoryGenerator
+{
+public:
+	/*
+	 * Changes whenever the generator starts making different trajectories from
+	 * the same waypoints, so that trajectories saved by an older version can
+	 * be recognized
+	 */
+	static const int VERSION = 1;
+
+	static const int MAX_WAYPOINTS = 16;
+	static const int MAX_POINTS = 4000;
+
+	struct Waypoint {
+		float x;
+		float y;
+		float heading; // degrees, the direction the robot faces
+	};
+
+	struct Limits {
+		float max_velocity;
+		float max_acceleration;
+		float max_jerk; // 0.0 for no jerk limit
+		float max_centripetal_acceleration;
+	};
+
+	TrajectoryGenerator(const Limits& limits, float period);
+
+	/**
+	 * Generates a straight move from start in the direction of its heading,
+	 * driving backwards if distance is negative
+	 * @return false if the trajectory didn't fit
+	 */
+	bool generateStraight(Trajectory& trajectory, const Waypoint& start, float distance);
+
+	/**
+	 * Generates a move through every waypoint, starting and ending at rest
+	 * @param reverse drive the path backwards, with the back of the robot
+	 *                leading.  The waypoint headings are still the direction
+	 *                the robot faces.
+	 * @return false if there were too few or too many waypoints, or the
+	 *         trajectory didn't fit
+	 */
+	bool generateSpline(Trajectory& trajectory, const Waypoint* waypoints, int waypoint_count, bool reverse);
+
+private:
+	struct Point {
+		float x;
+		float y;
+		float heading; // degrees, direction of travel
+		float distance; // along the path
+		float curvature;
+		float velocity;
+	};
+
+	Limits limits;
+	float period;
+
+	Point points[MAX_POINTS];
+	int point_count;
+
+	bool addSpline(const Waypoint& start, const Waypoint& end, float direction);
+	void limitVelocities();
+	bool resample(Trajectory& trajectory, float direction);
+};
+}
+
+#endif /* SRC_ED_TRAJECTORYGENERATOR_HPP_ */
@@ -0,0 +1,111 @@
+#include <ED/Histogram.hpp>
+#include <ED/InputSnapshot.hpp>
+#include <Latency.hpp>
+#include <Subsystems/Cameras.hpp>
+#include <Subsystems/OI.hpp>
+#include <Subsystems/Sensors.hpp>
+#include <WPILib.h>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace Latency
+{
+	// in the same order as Source
+	const char* const SOURCE_NAMES[] = {
+		"driver station",
+		"gyro",
+		"shooter tach",
+		"LIDAR",
+		"vision"
+	};
+	static_assert(sizeof(SOURCE_NAMES) / sizeof(*SOURCE_NAMES) == SOURCE_COUNT, "every source needs a name");
+
+	struct Tick {
+		double samples[SOURCE_COUNT]; // when each source was sampled, or 0.0 for never
+		double start;
+		double flush;
+	};
+
+	Tick tick = {};
+	double last_samples[SOURCE_COUNT] = {}; // the samples of the last tick, to tell which are new
+
+	// in microseconds
+	ED::Histogram waiting[SOURCE_COUNT]; // from the sample to the start of the tick
+	ED::Histogram total[SOURCE_COUNT]; // from the sample to the flush
+	ED::Histogram processing; // from the start of the tick to the flush
+
+	uint32_t toMicroseconds(double seconds)
+	{
+		// the vision frame time is an estimate, and can land after the tick starts
+		if (seconds < 0.0) {
+			return 0;
+		}
+		// anything over an hour is off the end anyway
+		if (seconds > 3600.0) {
+			return 0xFFFFFFFF;
+		}
+		return seconds * 1000000.0;
+	}
+
+	void startTick()
+	{
+		tick.start = Timer::GetFPGATimestamp();
+		tick.samples[GYRO] = Sensors::getGyroTimestamp();
+		tick.samples[SHOOTER_TACH] = Sensors::getShooterWheelTimestamp();
+		tick.samples[LIDAR] = Sensors::getLidarTimestamp();
+		tick.samples[VISION] = Cameras::getTargetTimestamp();
+	}
+
+	void finishTick()
+	{
+		tick.flush = Timer::GetFPGATimestamp();
+		tick.samples[DRIVER_STATION] = OI::getInputs().getTimestamp();
+
+		processing.record(toMicroseconds(tick.flush - tick.start));
+
+		for (int i = 0; i < SOURCE_COUNT; ++i) {
+			double sample = tick.samples[i];
+			if (sample == 0.0 || sample == last_samples[i]) {
+				continue;
+			}
+			last_samples[i] = sample;
+
+			// a driver station packet is captured during the tick, so it never waits for one
+			waiting[i].record(i == DRIVER_STATION ? 0 : toMicroseconds(tick.start - sample));
+			total[i].record(toMicroseconds(tick.flush - sample));
+		}
+	}
+
+	void report()
+	{
+		DriverStation::ReportError("input to output latency, milliseconds:");
+
+		char message[192];
+		if (processing.getCount() != 0) {
+			snprintf(message, sizeof(message), "tick start to flush: %u ticks, p50 %.2f, p99 %.2f, max %.2f",
+				processing.getCount(),
+				processing.getPercentile(0.5) / 1000.0, processing.getPercentile(0.99) / 1000.0, processing.getMax() / 1000.0);
+			DriverStation::ReportError(message);
+		}
+
+		for (int i = 0; i < SOURCE_COUNT; ++i) {
+			if (total[i].getCount() == 0) {
+				continue;
+			}
+			snprintf(message, sizeof(message), "%s: %u samples, to flush p50 %.2f, p99 %.2f, max %.2f, waiting for the tick p50 %.2f, p99 %.2f",
+				SOURCE_NAMES[i], total[i].getCount(),
+				total[i].getPercentile(0.5) / 1000.0, total[i].getPercentile(0.99) / 1000.0, total[i].getMax() / 1000.0,
+				waiting[i].getPercentile(0.5) / 1000.0, waiting[i].getPercentile(0.99) / 1000.0);
+			DriverStation::ReportError(message);
+		}
+	}
+
+	void clear()
+	{
+		for (int i = 0; i < SOURCE_COUNT; ++i) {
+			waiting[i].clear();
+			total[i].clear();
+		}
+		processing.clear();
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef SRC_LATENCY_H_
+#define SRC_LATENCY_H_
+
+/**
+ * Measures how long each input takes to reach the motors, from the time it
+ * was sampled to the time the outputs it changed were flushed.
+ *
+ * Every tick of an enabled loop carries the FPGA time of the driver station
+ * packet and of each sensor sample it used, along with the time the tick
+ * started and the time its outputs were flushed.  The first tick to use each
+ * new sample records its latency into histograms, split into the time the
+ * sample waited for the tick to start and the time until the flush.  report
+ * sends their median, 99th percentile and largest value to the driver
+ * station, alongside the profiler's report.
+ *
+ * Sensors sampled on other threads are read when the tick starts, since a
+ * sample that arrives later in the tick may have missed the subsystems that
+ * read it.  The driver station inputs are only captured on the loop's own
+ * thread, so they're read when it finishes.
+ */
+namespace Latency
+{
+	enum Source {
+		DRIVER_STATION, // the joysticks
+		GYRO, // the navX
+		SHOOTER_TACH,
+		LIDAR,
+		VISION, // the frame the target was found in
+
+		SOURCE_COUNT
+	};
+
+	/**
+	 * Reads the time of each sensor sample, at the start of the loop
+	 */
+	void startTick();
+
+	/**
+	 * Records the latency of each new sample, right after the outputs are
+	 * flushed
+	 */
+	void finishTick();
+
+	/**
+	 * Reports the latency of every source to the driver station
+	 */
+	void report();
+
+	/**
+	 * Forgets every latency recorded so far
+	 */
+	void clear();
+}
+
+#endif /* SRC_LATENCY_H_ */
@@ -46,6 +46,8 @@ class AHRSInternal : public IIOCompleteNotification, public IBoardCapabilities {
         ahrs->roll              	= ypr_update.roll;
         ahrs->compass_heading   	= ypr_update.compass_heading;
         ahrs->last_sensor_timestamp	= sensor_timestamp;
+
+        ahrs->yaw_angle_tracker->NextAngle(ahrs->GetYaw(), sensor_timestamp);
     }
 
     void SetAHRSPosData(AHRSProtocol::AHRSPosUpdate& ahrs_update, long sensor_timestamp) {
@@ -122,7 +124,7 @@ class AHRSInternal : public IIOCompleteNotification, public IBoardCapabilities {
         ahrs->displacement[1] = ahrs_update.disp_y;
         ahrs->displacement[2] = ahrs_update.disp_z;
 
-        ahrs->yaw_angle_tracker->NextAngle(ahrs->GetYaw());
+        ahrs->yaw_angle_tracker->NextAngle(ahrs->GetYaw(), sensor_timestamp);
         ahrs->last_sensor_timestamp	= sensor_timestamp;
     }
 
@@ -217,7 +219,7 @@ class AHRSInternal : public IIOCompleteNotification, public IBoardCapabilities {
                 ahrs->update_rate_hz,
                 ahrs->is_moving);
 
-        ahrs->yaw_angle_tracker->NextAngle(ahrs->GetYaw());
+        ahrs->yaw_angle_tracker->NextAngle(ahrs->GetYaw(), sensor_timestamp);
     }
 
     void SetBoardID(AHRSProtocol::BoardID& board_id) {
@@ -537,6 +539,18 @@ long AHRS::GetLastSensorTimestamp() {
 	return this->last_sensor_timestamp;
 }
 
+/**
+ * Returns the FPGA time at which the last sample was received
+ * from the sensor.  Unlike the sensor timestamp, this is on the
+ * same clock as Timer::GetFPGATimestamp(), and is provided for
+ * every IO method.
+ * @return The FPGA time in seconds of the last sample, or 0.0
+ * if no sample has been received yet.
+ */
+double AHRS::GetLastReceivedTimestamp() {
+	return yaw_angle_tracker->GetReceivedTimestamp();
+}
+
 /**
  * Returns the current linear acceleration in the X-axis (in G).
  *<p>
@@ -851,7 +865,7 @@ float AHRS::GetVelocityZ() {
  * @return Displacement since last reset (in meters).
  */
 float AHRS::GetDisplacementX() {
-    return (ahrs_internal->IsDisplacementSupported() ? displacement[0] : integrator->GetVelocityX());
+    return (ahrs_internal->IsDisplacementSupported() ? displacement[0] : integrator->GetDisplacementX());
 }
 
 /**
@@ -865,7 +879,7 @@ float AHRS::GetDisplacementX() {
  * @return Displacement since last reset (in meters).
  */
 float AHRS::GetDisplacementY() {
-    return (ahrs_internal->IsDisplacementSupported() ? displacement[1] : integrator->GetVelocityY());
+    return (ahrs_internal->IsDisplacementSupported() ? displacement[1] : integrator->GetDisplacementY());
 }
 
 /**
@@ -1017,7 +1031,10 @@ double AHRS::GetAngle() {
 /**
  * Return the rate of rotation of the yaw (Z-axis) gyro, in degrees per second.
  *<p>
- * The rate is based on the most recent reading of the yaw gyro angle.
+ * The rate is computed once per sample on the IO thread from the change in
+ * continuous yaw between the two most recent samples, divided by the time
+ * between their sensor timestamps.  It does not depend on how often this
+ * method is called.
  *<p>
  * @return The current rate of change in yaw angle (in degrees per second)
  */
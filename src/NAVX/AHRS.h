@@ -144,6 +144,7 @@ public:
     double GetByteCount();
     double GetUpdateCount();
     long   GetLastSensorTimestamp();
+    double GetLastReceivedTimestamp();
     float  GetWorldLinearAccelX();
     float  GetWorldLinearAccelY();
     float  GetWorldLinearAccelZ();
@@ -6,34 +6,40 @@
  */
 
 #include <NAVX/ContinuousAngleTracker.h>
-
-ContinuousAngleTracker::ContinuousAngleTracker() {
+#include <WPILib.h>
+
+ContinuousAngleTracker::ContinuousAngleTracker() :
+    lock(),
+    published_angle(0.0),
+    published_rate(0.0),
+    published_timestamp_ms(0),
+    published_received(0.0),
+    reset_requested(false),
+    angleAdjust(0.0)
+{
 	Init();
-    angleAdjust = 0.0f;
 }
 
 void ContinuousAngleTracker::Init() {
-    gyro_prevVal = 0.0;
+    gyro_prevVal = 0.0f;
     ctrRollOver  = 0;
     fFirstUse = true;
-    last_yaw_angle = 0.0f;
-    curr_yaw_angle = 0.0f;
-}
-
-void ContinuousAngleTracker::NextAngle( float newAngle ) {
-	std::unique_lock<priority_mutex> sync(tracker_mutex);
-	last_yaw_angle = curr_yaw_angle;
-	curr_yaw_angle = newAngle;
+    last_timestamp_ms = 0;
 }
 
-/* Invoked (internally) whenever yaw reset occurs. */
-void ContinuousAngleTracker::Reset() {
-	std::unique_lock<priority_mutex> sync(tracker_mutex);
-	Init();
-}
+void ContinuousAngleTracker::NextAngle( float newAngle, long sensor_timestamp ) {
+	// Serial transports do not provide a sensor timestamp, so fall back
+	// to the time at which the sample was received
+	double received = Timer::GetFPGATimestamp();
+	long timestamp_ms = sensor_timestamp;
+	if ( timestamp_ms == 0 ) {
+		timestamp_ms = (long)(received * 1000.0);
+	}
 
+	if ( reset_requested.exchange(false) ) {
+		Init();
+	}
 
-double ContinuousAngleTracker::GetAngle() {
 	// First case
 	// Old reading: +150 degrees
 	// New reading: +170 degrees
@@ -54,67 +60,91 @@ double ContinuousAngleTracker::GetAngle() {
 	// New reading: +179 degrees
 	// Difference:  (+179 - -179) = +358 degrees
 
-	double difference;
-	double gyroVal;
-	double yawVal;
-
-	{
-		std::unique_lock<priority_mutex> sync(tracker_mutex);
-
-		yawVal = curr_yaw_angle;
-
-		// Has gyro_prevVal been previously set?
-		// If not, return do not calculate, return current value
-		if( !fFirstUse )
-		{
-			// Determine count for rollover counter
-			difference = yawVal - gyro_prevVal;
-
-			/* Clockwise past +180 degrees
-			 * If difference > 180*, increment rollover counter */
-			if( difference < -180.0 ) {
-				ctrRollOver++;
-
-			/* Counter-clockwise past -180 degrees:
-			 * If difference > 180*, decrement rollover counter */
-			}
-			else if ( difference > 180.0 ) {
-				ctrRollOver--;
-			}
-		}
+	double difference = 0.0;
+	double rate = 0.0;
+	if ( !fFirstUse ) {
+		difference = newAngle - gyro_prevVal;
 
-		// Mark gyro_prevVal as being used
-		fFirstUse = false;
+		/* Clockwise past +180 degrees
+		 * If difference > 180*, increment rollover counter */
+		if ( difference < -180.0 ) {
+			ctrRollOver++;
+			difference += 360.0;
 
-		// Calculate value to return back to calling function
-		// e.g. +720 degrees or -360 degrees
-		gyroVal = yawVal + (360.0 * ctrRollOver);
-		gyro_prevVal = yawVal;
+		/* Counter-clockwise past -180 degrees:
+		 * If difference > 180*, decrement rollover counter */
+		}
+		else if ( difference > 180.0 ) {
+			ctrRollOver--;
+			difference -= 360.0;
+		}
 
-		return gyroVal + angleAdjust;
+		long delta_ms = timestamp_ms - last_timestamp_ms;
+		if ( delta_ms > 0 ) {
+			rate = difference * 1000.0 / (double)delta_ms;
+		}
+		else {
+			// a repeated sample carries no new rate information
+			rate = published_rate.load(std::memory_order_relaxed);
+		}
 	}
+
+	fFirstUse = false;
+	gyro_prevVal = newAngle;
+	last_timestamp_ms = timestamp_ms;
+
+	// e.g. +720 degrees or -360 degrees
+	Publish(newAngle + (360.0 * ctrRollOver), rate, timestamp_ms, received);
+}
+
+void ContinuousAngleTracker::Publish( double angle, double rate, long timestamp_ms, double received ) {
+	lock.write([&]() {
+		published_angle.store(angle, std::memory_order_relaxed);
+		published_rate.store(rate, std::memory_order_relaxed);
+		published_timestamp_ms.store(timestamp_ms, std::memory_order_relaxed);
+		published_received.store(received, std::memory_order_relaxed);
+	});
+}
+
+/* Invoked (internally) whenever yaw reset occurs. */
+void ContinuousAngleTracker::Reset() {
+	reset_requested = true;
+}
+
+void ContinuousAngleTracker::GetState( double& angle, double& rate, long& timestamp_ms ) const {
+	lock.read([&]() {
+		angle = published_angle.load(std::memory_order_relaxed);
+		rate = published_rate.load(std::memory_order_relaxed);
+		timestamp_ms = published_timestamp_ms.load(std::memory_order_relaxed);
+	});
+
+	angle += angleAdjust.load(std::memory_order_relaxed);
+}
+
+double ContinuousAngleTracker::GetAngle() const {
+	double angle;
+	double rate;
+	long timestamp_ms;
+	GetState(angle, rate, timestamp_ms);
+	return angle;
+}
+
+double ContinuousAngleTracker::GetReceivedTimestamp() const {
+	return published_received.load(std::memory_order_relaxed);
 }
 
 void ContinuousAngleTracker::SetAngleAdjustment(double adjustment) {
 	angleAdjust = adjustment;
 }
 
-double ContinuousAngleTracker::GetAngleAdjustment() {
+double ContinuousAngleTracker::GetAngleAdjustment() const {
 	return angleAdjust;
 }
 
-double ContinuousAngleTracker::GetRate() {
-	float difference;
-	{
-		std::unique_lock<priority_mutex> sync(tracker_mutex);
-		difference = curr_yaw_angle - last_yaw_angle;
-	}
-	if ( difference > 180.0f) {
-		/* Clockwise past +180 degrees */
-		difference = 360.0f - difference;
-	} else if ( difference < -180.0f) {
-		/* Counter-clockwise past -180 degrees */
-		difference = 360.0f + difference;
-	}
-	return difference;
+double ContinuousAngleTracker::GetRate() const {
+	double angle;
+	double rate;
+	long timestamp_ms;
+	GetState(angle, rate, timestamp_ms);
+	return rate;
 }
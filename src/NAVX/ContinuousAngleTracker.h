@@ -8,28 +8,84 @@
 #ifndef SRC_CONTINUOUSANGLETRACKER_H_
 #define SRC_CONTINUOUSANGLETRACKER_H_
 
-#include <WPILib.h>
+#include <atomic>
+#include <stdint.h>
+#include <ED/SequenceLock.hpp>
 
+/**
+ * Converts the [-180, 180] yaw reported by the navX into a continuous angle
+ * and a yaw rate in degrees per second.
+ *
+ * All of the unwrapping happens in NextAngle(), which is only ever called by
+ * the navX IO thread, once per sample.  The results are published through a
+ * sequence lock so that any number of readers on any number of threads can
+ * call GetAngle() and GetRate() without taking a mutex, and so that the
+ * returned values no longer depend on how often they are polled.
+ */
 class ContinuousAngleTracker {
 private:
+    /* Producer (IO thread) state, never touched by readers */
     bool fFirstUse;
-    double gyro_prevVal;
+    float gyro_prevVal;
     int ctrRollOver;
-    float curr_yaw_angle;
-    float last_yaw_angle;
-    double angleAdjust;
-    priority_mutex tracker_mutex;
+    long last_timestamp_ms;
+
+    /* Published state */
+    ED::SequenceLock lock;
+    std::atomic<double> published_angle;
+    std::atomic<double> published_rate;
+    std::atomic<long> published_timestamp_ms;
+    std::atomic<double> published_received;
+
+    std::atomic<bool> reset_requested;
+    std::atomic<double> angleAdjust;
 
     void Init();
+    void Publish( double angle, double rate, long timestamp_ms, double received );
 
 public:
     ContinuousAngleTracker();
+
+    /**
+     * Requests that the rollover history be cleared.  The request is
+     * serviced by the IO thread on the next call to NextAngle(), so this
+     * is safe to call from any thread.
+     */
     void Reset();
-    void NextAngle( float newAngle );
-    double GetAngle();
-    double GetRate();
+
+    /**
+     * Feeds a new [-180, 180] yaw sample to the tracker.  Must only be
+     * called from the thread which reads the sensor.
+     * @param newAngle         the yaw reported with the sample
+     * @param sensor_timestamp the navX timestamp of the sample in
+     *                         milliseconds, or 0 if the transport does not
+     *                         provide one (in which case the FPGA clock is used)
+     */
+    void NextAngle( float newAngle, long sensor_timestamp );
+
+    /**
+     * @return the continuous (unwrapped) yaw in degrees, including the
+     *         angle adjustment
+     */
+    double GetAngle() const;
+    /**
+     * @return the yaw rate in degrees per second, computed from the
+     *         timestamps of the two most recent samples
+     */
+    double GetRate() const;
+    /**
+     * Reads the continuous angle, rate and sample timestamp as one
+     * consistent set.
+     */
+    void GetState( double& angle, double& rate, long& timestamp_ms ) const;
+    /**
+     * @return the FPGA time in seconds at which the IO thread received the
+     *         latest sample, which unlike the sensor timestamp is on the
+     *         same clock as the rest of the robot, or 0.0 before the first
+     */
+    double GetReceivedTimestamp() const;
 	void SetAngleAdjustment(double adjustment);
-	double GetAngleAdjustment();
+	double GetAngleAdjustment() const;
 };
 
 #endif /* SRC_CONTINUOUSANGLETRACKER_H_ */
@@ -23,7 +23,7 @@ void InertialDataIntegrator::UpdateDisplacement( float accel_x_g, float accel_y_
         for ( int i = 0; i < 2; i++ ) {
             accel_m_s2[i] = accel_g[i] * 9.80665f;
             curr_velocity_m_s[i] = last_velocity[i] + (accel_m_s2[i] * sample_time);
-            displacement[i] += last_velocity[i] + (0.5f * accel_m_s2[i] * sample_time * sample_time);
+            displacement[i] += (last_velocity[i] * sample_time) + (0.5f * accel_m_s2[i] * sample_time * sample_time);
             last_velocity[i] = curr_velocity_m_s[i];
         }
     } else {
@@ -8,6 +8,7 @@
 #include <NAVX/RegisterIO.h>
 #include <NAVX/IMURegisters.h>
 #include <NAVX/delay.h>
+#include <Trace.hpp>
 
 RegisterIO::RegisterIO( IRegisterIO *io_provider,
         uint8_t update_rate_hz,
@@ -67,6 +68,7 @@ void RegisterIO::ZeroDisplacement() {
 }
 
 void RegisterIO::Run() {
+    Trace::nameThread("navX IO");
     io_provider->Init();
 
     /* Initial Device Configuration */
@@ -83,7 +85,10 @@ void RegisterIO::Run() {
         if ( board_state.update_rate_hz != this->update_rate_hz ) {
             SetUpdateRateHz(this->update_rate_hz);
         }
-        GetCurrentData();
+        {
+            Trace::Scope read_scope("navX register read");
+            GetCurrentData();
+        }
         delayMillis(update_rate_ms);
     }
 }
@@ -7,6 +7,7 @@
 
 #include <NAVX/SerialIO.h>
 #include <NAVX/delay.h>
+#include <Trace.hpp>
 
 static const double IO_TIMEOUT_SECONDS = 1.0;
 
@@ -133,6 +134,7 @@ int SerialIO::DecodePacketHandler(char * received_data, int bytes_remaining) {
 }
 
 void SerialIO::Run() {
+    Trace::nameThread("navX IO");
     stop = false;
     bool stream_response_received = false;
     double last_stream_command_sent_timestamp = 0.0;
@@ -225,7 +227,11 @@ void SerialIO::Run() {
             }
 
             int packets_received = 0;
-            int bytes_read = serial_port->Read(received_data, sizeof(received_data));
+            int bytes_read;
+            {
+                Trace::Scope read_scope("navX serial read");
+                bytes_read = serial_port->Read(received_data, sizeof(received_data));
+            }
             byte_count += bytes_read;
 
             /* If a partial packet remains from last iteration, place that at  */
@@ -0,0 +1,87 @@
+#include <ED/BufferedMotor.hpp>
+#include <ED/StaticPool.hpp>
+#include <Outputs.hpp>
+#include <WPILib.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace Outputs
+{
+	const int MAX_MOTORS = 16;
+	const double RATE_PERIOD = 1.0; // seconds over which write rates are measured
+
+	// some motors are made during static initialization, so nothing here
+	// can need constructing
+	ED::StaticPool<ED::BufferedMotor, MAX_MOTORS> motor_pool;
+	ED::BufferedMotor* motors[MAX_MOTORS];
+	unsigned int ports[MAX_MOTORS];
+	int motor_count = 0;
+
+	uint32_t last_write_counts[MAX_MOTORS];
+	float write_rates[MAX_MOTORS];
+	double last_rate_time = 0.0;
+
+	SpeedController* add(unsigned int port, SpeedController* motor)
+	{
+		ED::BufferedMotor* buffered_motor = motor_pool.make(motor);
+		if (buffered_motor == nullptr) {
+			// there's no room to flush another motor either, so writing it
+			// directly is the only way it still works
+			DriverStation::ReportError("too many motors to buffer, raise Outputs::MAX_MOTORS");
+			return motor;
+		}
+		motors[motor_count] = buffered_motor;
+		ports[motor_count] = port;
+		last_write_counts[motor_count] = 0;
+		write_rates[motor_count] = 0.0;
+		++motor_count;
+		return buffered_motor;
+	}
+
+	void setInterlock(unsigned int port, ED::BufferedMotor::Interlock interlock)
+	{
+		for (int i = 0; i < motor_count; ++i) {
+			if (ports[i] == port) {
+				motors[i]->setInterlock(interlock);
+			}
+		}
+	}
+
+	void flush()
+	{
+		for (int i = 0; i < motor_count; ++i) {
+			motors[i]->flush();
+		}
+
+		// keep the rates from the last enabled second for report
+		double time = Timer::GetFPGATimestamp();
+		if (time - last_rate_time >= RATE_PERIOD && DriverStation::GetInstance().IsEnabled()) {
+			for (int i = 0; i < motor_count; ++i) {
+				uint32_t write_count = motors[i]->getWriteCount();
+				write_rates[i] = (write_count - last_write_counts[i]) / (time - last_rate_time);
+				last_write_counts[i] = write_count;
+			}
+			last_rate_time = time;
+		}
+	}
+
+	float getWriteRate(unsigned int port)
+	{
+		for (int i = 0; i < motor_count; ++i) {
+			if (ports[i] == port) {
+				return write_rates[i];
+			}
+		}
+		return 0.0;
+	}
+
+	void report()
+	{
+		char message[512] = "motor writes per second:";
+		int length = strlen(message);
+		for (int i = 0; i < motor_count && length < (int)sizeof(message); ++i) {
+			length += snprintf(message + length, sizeof(message) - length, " %u: %.1f", ports[i], write_rates[i]);
+		}
+		DriverStation::ReportError(message);
+	}
+}
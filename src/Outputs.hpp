@@ -0,0 +1,51 @@
+#ifndef SRC_OUTPUTS_H_
+#define SRC_OUTPUTS_H_
+
+#include <ED/BufferedMotor.hpp>
+
+/**
+ * Collects the speeds the subsystems set on their motors over a loop, and
+ * writes them all at once at the end of it.
+ *
+ * Every motor made by Utils::constructMotor is buffered here, so that a
+ * subsystem setting the same speed loop after loop, or several speeds in one
+ * loop, only costs a write when the final speed changes.  flush must be
+ * called at the end of every loop, disabled ones included, or nothing
+ * reaches the motors.
+ */
+namespace Outputs
+{
+	/**
+	 * Buffers a motor, returning the buffered motor to use in its place
+	 *
+	 * If MAX_MOTORS are already buffered, the motor itself is returned, so it
+	 * still runs, just without buffering or an interlock.
+	 * @param port  the port the motor is on, which identifies it here
+	 * @param motor the motor to buffer
+	 */
+	SpeedController* add(unsigned int port, SpeedController* motor);
+
+	/**
+	 * Sets the interlock applied to the final speed of the motor on a port
+	 * each loop
+	 */
+	void setInterlock(unsigned int port, ED::BufferedMotor::Interlock interlock);
+
+	/**
+	 * Writes every motor whose speed changed since the last flush
+	 */
+	void flush();
+
+	/**
+	 * Returns the writes per second to the motor on a port over the last
+	 * second the robot was enabled
+	 */
+	float getWriteRate(unsigned int port);
+
+	/**
+	 * Reports the write rates of every motor to the driver station
+	 */
+	void report();
+}
+
+#endif /* SRC_OUTPUTS_H_ */
@@ -41,6 +41,7 @@ namespace OIPorts
 	const unsigned int AUTO_CLIMBER_DEPLOY_BUTTON = 3;
 	const unsigned int AUTO_WINCH_BUTTON = 4;
 	const unsigned int MANUAL_WINCH_ENABLE_SWITCH = 5;
+	const unsigned int PROFILE_REPORT_BUTTON = 6;
 
 	// buttons joystick 2, analog
 	const unsigned int FRONT_WINCH_JOYSTICK = JOYSTICK_X_PORT; // X
@@ -42,6 +42,7 @@ namespace OIPorts
 	extern const unsigned int AUTO_CLIMBER_DEPLOY_BUTTON;
 	extern const unsigned int AUTO_WINCH_BUTTON;
 	extern const unsigned int MANUAL_WINCH_ENABLE_SWITCH;
+	extern const unsigned int PROFILE_REPORT_BUTTON;
 
 	// buttons joystick 2, analog
 	extern const unsigned int FRONT_WINCH_JOYSTICK; // X
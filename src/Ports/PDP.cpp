@@ -0,0 +1,15 @@
+#include <Ports/PDP.hpp>
+
+namespace PDPPorts
+{
+	// power distribution panel channels, TODO: check against the wiring
+	const unsigned int RIGHT_MOTOR1 = 0;
+	const unsigned int RIGHT_MOTOR2 = 1;
+	const unsigned int LEFT_MOTOR1 = 14;
+	const unsigned int LEFT_MOTOR2 = 15;
+
+	const unsigned int FRONT_WINCH_MOTOR = 2;
+	const unsigned int BACK_WINCH_MOTOR = 3;
+
+	const unsigned int SHOOTER_WHEELS_MOTOR = 12;
+}
@@ -0,0 +1,17 @@
+#ifndef SRC_PORTS_PDP_H_
+#define SRC_PORTS_PDP_H_
+
+namespace PDPPorts
+{
+	extern const unsigned int RIGHT_MOTOR1;
+	extern const unsigned int RIGHT_MOTOR2;
+	extern const unsigned int LEFT_MOTOR1;
+	extern const unsigned int LEFT_MOTOR2;
+
+	extern const unsigned int FRONT_WINCH_MOTOR;
+	extern const unsigned int BACK_WINCH_MOTOR;
+
+	extern const unsigned int SHOOTER_WHEELS_MOTOR;
+}
+
+#endif /* SRC_PORTS_PDP_H_ */
@@ -0,0 +1,104 @@
+#include <ED/Histogram.hpp>
+#include <Profiler.hpp>
+#include <Trace.hpp>
+#include <WPILib.h>
+#include <chrono>
+#include <stdio.h>
+
+namespace Profiler
+{
+	// in the same order as Section
+	const char* const SECTION_NAMES[] = {
+		"loop",
+		
+		"Autonomous::process",
+		"Cameras::process",
+		"ClimberArm::process",
+		"Coordination::process",
+		"HolderWheels::process",
+		"IntakeAngle::process",
+		"IntakeRoller::process",
+		"Mobility::process",
+		"Odometry::process",
+		"OI::process",
+		"PowerBudget::process",
+		"Sensors::process",
+		"ShooterPitch::process",
+		"ShooterWheels::process",
+		"ShotTable::process",
+		"Winches::process",
+		
+		"IntakeAngle::processPID",
+		"ShooterPitch::processPID",
+		"ShooterWheels::processPID",
+		
+		"Outputs::flush",
+		"LIDAR transaction",
+		"GRIP read"
+	};
+	static_assert(sizeof(SECTION_NAMES) / sizeof(*SECTION_NAMES) == SECTION_COUNT, "every section needs a name");
+
+	ED::Histogram histograms[SECTION_COUNT];
+
+	Scope::Scope(Section section) :
+		section(section),
+		start(now())
+	{
+
+	}
+
+	Scope::~Scope()
+	{
+		uint64_t end = now();
+		record(section, end - start);
+		Trace::record(SECTION_NAMES[section], start, end);
+	}
+
+	void run(Section section, void (*function)())
+	{
+		uint64_t start = now();
+		function();
+		uint64_t end = now();
+		record(section, end - start);
+		Trace::record(SECTION_NAMES[section], start, end);
+	}
+
+	uint64_t now()
+	{
+		using namespace std::chrono;
+		return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	void record(Section section, uint64_t duration)
+	{
+		if (section < 0 || section >= SECTION_COUNT) {
+			return;
+		}
+		// anything over four seconds is off the end anyway
+		histograms[section].record(duration > 0xFFFFFFFF ? 0xFFFFFFFF : duration);
+	}
+
+	void report()
+	{
+		DriverStation::ReportError("loop profile, microseconds:");
+
+		char message[160];
+		for (int i = 0; i < SECTION_COUNT; ++i) {
+			const ED::Histogram& histogram = histograms[i];
+			if (histogram.getCount() == 0) {
+				continue;
+			}
+			snprintf(message, sizeof(message), "%s: %u runs, p50 %.1f, p99 %.1f, max %.1f",
+				SECTION_NAMES[i], histogram.getCount(),
+				histogram.getPercentile(0.5) / 1000.0, histogram.getPercentile(0.99) / 1000.0, histogram.getMax() / 1000.0);
+			DriverStation::ReportError(message);
+		}
+	}
+
+	void clear()
+	{
+		for (int i = 0; i < SECTION_COUNT; ++i) {
+			histograms[i].clear();
+		}
+	}
+}
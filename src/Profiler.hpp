@@ -0,0 +1,94 @@
+#ifndef SRC_PROFILER_H_
+#define SRC_PROFILER_H_
+
+#include <stdint.h>
+
+/**
+ * Times the sections of the control loop into histograms, to find out which
+ * of them the loop spends its time in.
+ *
+ * Each section's durations are counted in an ED::Histogram, in fixed memory,
+ * timed with the monotonic clock in nanoseconds.  report sends the median,
+ * 99th percentile and longest duration of every section that has run to the
+ * driver station, which the disabled loop does when the profile report button
+ * is pressed.
+ *
+ * Sections timed by Scope and run are also recorded in the trace, while
+ * tracing.
+ *
+ * Each section must only be timed from one thread.
+ */
+namespace Profiler
+{
+	enum Section {
+		LOOP,
+		
+		AUTONOMOUS_PROCESS,
+		CAMERAS_PROCESS,
+		CLIMBER_ARM_PROCESS,
+		COORDINATION_PROCESS,
+		HOLDER_WHEELS_PROCESS,
+		INTAKE_ANGLE_PROCESS,
+		INTAKE_ROLLER_PROCESS,
+		MOBILITY_PROCESS,
+		ODOMETRY_PROCESS,
+		OI_PROCESS,
+		POWER_BUDGET_PROCESS,
+		SENSORS_PROCESS,
+		SHOOTER_PITCH_PROCESS,
+		SHOOTER_WHEELS_PROCESS,
+		SHOT_TABLE_PROCESS,
+		WINCHES_PROCESS,
+		
+		INTAKE_ANGLE_PID,
+		SHOOTER_PITCH_PID,
+		SHOOTER_WHEELS_PID,
+		
+		OUTPUTS_FLUSH,
+		LIDAR_TRANSACTION, // one stage of a LIDAR reading over I2C
+		GRIP_READ, // reading GRIP's contours from NetworkTables, on its own thread
+		
+		SECTION_COUNT
+	};
+
+	/**
+	 * Times a section from its construction to its destruction
+	 */
+	class Scope
+	{
+	public:
+		explicit Scope(Section section);
+		~Scope();
+
+	private:
+		Section section;
+		uint64_t start;
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	/**
+	 * Calls a function, timing it as a section
+	 */
+	void run(Section section, void (*function)());
+
+	/**
+	 * Returns the monotonic time in nanoseconds
+	 */
+	uint64_t now();
+
+	void record(Section section, uint64_t duration);
+
+	/**
+	 * Reports the durations of every section to the driver station
+	 */
+	void report();
+
+	/**
+	 * Forgets every duration recorded so far
+	 */
+	void clear();
+}
+
+#endif /* SRC_PROFILER_H_ */
@@ -1,4 +1,10 @@
+#include <Allocations.hpp>
+#include <Autonomous.hpp>
+#include <Characterization.hpp>
 #include <Coordination.hpp>
+#include <Latency.hpp>
+#include <Outputs.hpp>
+#include <Profiler.hpp>
 #include <Robot.hpp>
 #include <Subsystems/Cameras.hpp>
 #include <Subsystems/ClimberArm.hpp>
@@ -6,15 +12,30 @@
 #include <Subsystems/IntakeAngle.hpp>
 #include <Subsystems/IntakeRoller.hpp>
 #include <Subsystems/Mobility.hpp>
+#include <Subsystems/Odometry.hpp>
 #include <Subsystems/OI.hpp>
+#include <Subsystems/PowerBudget.hpp>
 #include <Subsystems/Sensors.hpp>
 #include <Subsystems/ShooterPitch.hpp>
 #include <Subsystems/ShooterWheels.hpp>
+#include <Subsystems/ShotTable.hpp>
 #include <Subsystems/Winches.hpp>
+#include <Trace.hpp>
+#include <Tuning.hpp>
 #include <WPILib.h>
 
+// stop the program at the first heap allocation in an enabled loop, for
+// finding them on a bench
+const bool TRAP_ALLOCATIONS = false;
+
+// record a timeline of every enabled period, written out when it ends
+const bool TRACE_LOOPS = false;
+const char* const TRACE_PATH = "/home/lvuser/trace.json";
+
 void Robot::RobotInit()
 {
+	Trace::nameThread("main");
+	
 	Cameras::initialize();
 	ClimberArm::initialize();
 	HolderWheels::initialize();
@@ -22,12 +43,21 @@ void Robot::RobotInit()
 	IntakeRoller::initialize();
 	Mobility::initialize();
 	OI::initialize();
+	PowerBudget::initialize();
 	Sensors::initialize();
+	Odometry::initialize(); // must come after Sensors
 	ShooterPitch::initialize();
 	ShooterWheels::initialize();
+	ShotTable::initialize();
 	Winches::initialize();
 	
+	Autonomous::loadTrajectories();
 	Coordination::initialize();
+	Tuning::initialize(); // must come after the subsystems
+	Characterization::initialize(); // must come after Mobility
+	
+	// everything the loops need has been made by now
+	Allocations::startCounting();
 }
 
 void Robot::Disabled()
@@ -38,6 +68,15 @@ void Robot::Disabled()
 	
 	interruptAll();
 	
+	// from the loop that just ended
+	Allocations::trap(false);
+	Allocations::report();
+	Outputs::report();
+	if (Trace::isTracing()) {
+		Trace::stop();
+		Trace::write(TRACE_PATH);
+	}
+	
 	char message[1023];
 	while (!IsEnabled()) {
 		snprintf(message, 1023, "sees goal: %d, shooter angle: %.2f, shooter rpm: %.2f, intake angle: %.2f, ball switch: %d, home switch: %d, lidar dist: %d",
@@ -49,6 +88,18 @@ void Robot::Disabled()
 			Sensors::isShooterLimitPressed(),
 			Sensors::getLidarDistance());
 		DriverStation::ReportError(message);
+		
+		ShotTable::reloadIfChanged();
+		
+		OI::captureInputs();
+		if (OI::isProfileReportRequested()) {
+			Profiler::report();
+			Profiler::clear();
+			Latency::report();
+			Latency::clear();
+		}
+		
+		Outputs::flush();
 	}
 }
 
@@ -60,24 +111,45 @@ void Robot::Autonomous()
 	
 	interruptAll();
 	
+	Autonomous::initialize(Sensors::getAutonomousPosition(), Sensors::getAutonomousDefense(), Sensors::getAutonomousShoot());
+	
+	Allocations::clear();
+	Allocations::trap(TRAP_ALLOCATIONS);
+	if (TRACE_LOOPS) {
+		Trace::start();
+	}
+	
 	while (IsEnabled() && IsAutonomous()) {
-		Cameras::process();
-		ClimberArm::process();
-		HolderWheels::process();
-		IntakeAngle::process();
-		IntakeRoller::process();
-		Mobility::process();
-		Sensors::process();
-		ShooterPitch::process();
-		ShooterWheels::process();
-		Winches::process();
+		Profiler::Scope loop_scope(Profiler::LOOP);
+		Latency::startTick();
+		
+		Profiler::run(Profiler::AUTONOMOUS_PROCESS, Autonomous::process);
+		Profiler::run(Profiler::COORDINATION_PROCESS, Coordination::process);
+		
+		Profiler::run(Profiler::CAMERAS_PROCESS, Cameras::process);
+		Profiler::run(Profiler::CLIMBER_ARM_PROCESS, ClimberArm::process);
+		Profiler::run(Profiler::HOLDER_WHEELS_PROCESS, HolderWheels::process);
+		Profiler::run(Profiler::INTAKE_ANGLE_PROCESS, IntakeAngle::process);
+		Profiler::run(Profiler::INTAKE_ROLLER_PROCESS, IntakeRoller::process);
+		Profiler::run(Profiler::MOBILITY_PROCESS, Mobility::process);
+		Profiler::run(Profiler::ODOMETRY_PROCESS, Odometry::process);
+		Profiler::run(Profiler::POWER_BUDGET_PROCESS, PowerBudget::process);
+		Profiler::run(Profiler::SENSORS_PROCESS, Sensors::process);
+		Profiler::run(Profiler::SHOOTER_PITCH_PROCESS, ShooterPitch::process);
+		Profiler::run(Profiler::SHOOTER_WHEELS_PROCESS, ShooterWheels::process);
+		Profiler::run(Profiler::SHOT_TABLE_PROCESS, ShotTable::process);
+		Profiler::run(Profiler::WINCHES_PROCESS, Winches::process);
 		
 		processPID();
+		
+		Profiler::run(Profiler::OUTPUTS_FLUSH, Outputs::flush);
+		Latency::finishTick();
 	}
 }
 
 void Robot::OperatorControl()
 {
+	OI::captureInputs();
 	bool enable_pid = OI::isPIDEnabled();
 	IntakeAngle::enablePID(enable_pid);
 	ShooterPitch::enablePID(enable_pid);
@@ -85,38 +157,69 @@ void Robot::OperatorControl()
 	
 	interruptAll();
 	
+	Allocations::clear();
+	Allocations::trap(TRAP_ALLOCATIONS);
+	if (TRACE_LOOPS) {
+		Trace::start();
+	}
+	
 	while (IsEnabled() && IsOperatorControl()) {
-		Cameras::process();
-		ClimberArm::process();
-		HolderWheels::process();
-		IntakeAngle::process();
-		IntakeRoller::process();
-		Mobility::process();
-		OI::process();
-		Sensors::process();
-		ShooterPitch::process();
-		ShooterWheels::process();
-		Winches::process();
+		Profiler::Scope loop_scope(Profiler::LOOP);
+		Latency::startTick();
+		
+		Profiler::run(Profiler::COORDINATION_PROCESS, Coordination::process);
+		
+		Profiler::run(Profiler::CAMERAS_PROCESS, Cameras::process);
+		Profiler::run(Profiler::CLIMBER_ARM_PROCESS, ClimberArm::process);
+		Profiler::run(Profiler::HOLDER_WHEELS_PROCESS, HolderWheels::process);
+		Profiler::run(Profiler::INTAKE_ANGLE_PROCESS, IntakeAngle::process);
+		Profiler::run(Profiler::INTAKE_ROLLER_PROCESS, IntakeRoller::process);
+		Profiler::run(Profiler::MOBILITY_PROCESS, Mobility::process);
+		Profiler::run(Profiler::ODOMETRY_PROCESS, Odometry::process);
+		Profiler::run(Profiler::OI_PROCESS, OI::process);
+		Profiler::run(Profiler::POWER_BUDGET_PROCESS, PowerBudget::process);
+		Profiler::run(Profiler::SENSORS_PROCESS, Sensors::process);
+		Profiler::run(Profiler::SHOOTER_PITCH_PROCESS, ShooterPitch::process);
+		Profiler::run(Profiler::SHOOTER_WHEELS_PROCESS, ShooterWheels::process);
+		Profiler::run(Profiler::SHOT_TABLE_PROCESS, ShotTable::process);
+		Profiler::run(Profiler::WINCHES_PROCESS, Winches::process);
 		
 		processPID();
+		
+		Profiler::run(Profiler::OUTPUTS_FLUSH, Outputs::flush);
+		Latency::finishTick();
 	}
 }
 
 /**
- * Runs during test mode
+ * Runs during test mode, tuning the mechanism picked by the autonomous
+ * position switch
  */
 void Robot::Test()
 {
+	IntakeAngle::enablePID(false);
+	ShooterPitch::enablePID(false);
+	ShooterWheels::enablePID(false);
+	
+	interruptAll();
+	
+	Tuning::startAutotune((Tuning::Mechanism)Sensors::getAutonomousPosition());
+	
 	while (IsEnabled() && IsTest()) {
-
+		Sensors::process();
+		Tuning::process();
+		
+		Outputs::flush();
 	}
+	
+	Tuning::stopAutotune();
 }
 
 void Robot::processPID()
 {
-	IntakeAngle::processPID();
-	ShooterPitch::processPID();
-	ShooterWheels::processPID();
+	Profiler::run(Profiler::INTAKE_ANGLE_PID, IntakeAngle::processPID);
+	Profiler::run(Profiler::SHOOTER_PITCH_PID, ShooterPitch::processPID);
+	Profiler::run(Profiler::SHOOTER_WHEELS_PID, ShooterWheels::processPID);
 }
 
 void Robot::interruptAll()
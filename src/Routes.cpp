@@ -0,0 +1,136 @@
+#include <Routes.hpp>
+#include <stddef.h>
+
+namespace Routes
+{
+	const char* const CACHE_PATH = "/home/lvuser/trajectories.bin";
+
+	const float START_X[START_POSITIONS] = { 1250.0, 480.0, 480.0, 480.0, 480.0, 480.0 }; // TODO: measure on the field
+	const float START_Y[START_POSITIONS] = { 100.0, 730.0, 600.0, 470.0, 340.0, 210.0 };
+
+	const float DEFENSE_NEAR_X = 560.0; // touching the defense from the neutral zone, TODO: measure
+	const float DEFENSE_FAR_X = 820.0; // clear of the defense in the courtyard
+
+	// where the robot shoots from, facing the goal
+	const float SHOT_X = 1250.0;
+	const float SHOT_Y = 405.0;
+	const float SPY_SHOT_X = 1400.0;
+	const float SPY_SHOT_Y = 220.0;
+	const float SPY_SHOT_HEADING = 37.0;
+
+	const ED::TrajectoryGenerator::Limits LIMITS = {
+		250.0, // max velocity, cm/s
+		200.0, // max acceleration, cm/s^2
+		1200.0, // max jerk, cm/s^3
+		150.0 // max centripetal acceleration, cm/s^2
+	};
+	const float PERIOD = 0.01; // seconds between samples
+
+	const Route ROUTES[] = {
+		{ Autonomous::Play::MOVE_TO_DEFENSE, 1, false, 2, { { START_X[1], START_Y[1], 0.0 }, { DEFENSE_NEAR_X, START_Y[1], 0.0 } } },
+		{ Autonomous::Play::MOVE_TO_DEFENSE, 2, false, 2, { { START_X[2], START_Y[2], 0.0 }, { DEFENSE_NEAR_X, START_Y[2], 0.0 } } },
+		{ Autonomous::Play::MOVE_TO_DEFENSE, 3, false, 2, { { START_X[3], START_Y[3], 0.0 }, { DEFENSE_NEAR_X, START_Y[3], 0.0 } } },
+		{ Autonomous::Play::MOVE_TO_DEFENSE, 4, false, 2, { { START_X[4], START_Y[4], 0.0 }, { DEFENSE_NEAR_X, START_Y[4], 0.0 } } },
+		{ Autonomous::Play::MOVE_TO_DEFENSE, 5, false, 2, { { START_X[5], START_Y[5], 0.0 }, { DEFENSE_NEAR_X, START_Y[5], 0.0 } } },
+
+		{ Autonomous::Play::CROSS_DEFENSE, 1, false, 2, { { START_X[1], START_Y[1], 0.0 }, { DEFENSE_FAR_X, START_Y[1], 0.0 } } },
+		{ Autonomous::Play::CROSS_DEFENSE, 2, false, 2, { { START_X[2], START_Y[2], 0.0 }, { DEFENSE_FAR_X, START_Y[2], 0.0 } } },
+		{ Autonomous::Play::CROSS_DEFENSE, 3, false, 2, { { START_X[3], START_Y[3], 0.0 }, { DEFENSE_FAR_X, START_Y[3], 0.0 } } },
+		{ Autonomous::Play::CROSS_DEFENSE, 4, false, 2, { { START_X[4], START_Y[4], 0.0 }, { DEFENSE_FAR_X, START_Y[4], 0.0 } } },
+		{ Autonomous::Play::CROSS_DEFENSE, 5, false, 2, { { START_X[5], START_Y[5], 0.0 }, { DEFENSE_FAR_X, START_Y[5], 0.0 } } },
+
+		{ Autonomous::Play::CROSS_DEFENSE_SHOOT, 1, false, 3, { { START_X[1], START_Y[1], 0.0 }, { DEFENSE_FAR_X, START_Y[1], 0.0 }, { SHOT_X, SHOT_Y, 0.0 } } },
+		{ Autonomous::Play::CROSS_DEFENSE_SHOOT, 2, false, 3, { { START_X[2], START_Y[2], 0.0 }, { DEFENSE_FAR_X, START_Y[2], 0.0 }, { SHOT_X, SHOT_Y, 0.0 } } },
+		{ Autonomous::Play::CROSS_DEFENSE_SHOOT, 3, false, 3, { { START_X[3], START_Y[3], 0.0 }, { DEFENSE_FAR_X, START_Y[3], 0.0 }, { SHOT_X, SHOT_Y, 0.0 } } },
+		{ Autonomous::Play::CROSS_DEFENSE_SHOOT, 4, false, 3, { { START_X[4], START_Y[4], 0.0 }, { DEFENSE_FAR_X, START_Y[4], 0.0 }, { SHOT_X, SHOT_Y, 0.0 } } },
+		{ Autonomous::Play::CROSS_DEFENSE_SHOOT, 5, false, 3, { { START_X[5], START_Y[5], 0.0 }, { DEFENSE_FAR_X, START_Y[5], 0.0 }, { SHOT_X, SHOT_Y, 0.0 } } },
+
+		{ Autonomous::Play::SPY_BOT_SHOOT, 0, false, 2, { { START_X[0], START_Y[0], 0.0 }, { SPY_SHOT_X, SPY_SHOT_Y, SPY_SHOT_HEADING } } },
+
+		// after driving the SPY_BOT_SHOOT route and shooting, back up to reach a defense from the courtyard
+		{ Autonomous::Play::SPY_BOT_SHOOT_REACH, 1, true, 2, { { SPY_SHOT_X, SPY_SHOT_Y, SPY_SHOT_HEADING }, { DEFENSE_FAR_X, START_Y[1], 0.0 } } },
+		{ Autonomous::Play::SPY_BOT_SHOOT_REACH, 2, true, 2, { { SPY_SHOT_X, SPY_SHOT_Y, SPY_SHOT_HEADING }, { DEFENSE_FAR_X, START_Y[2], 0.0 } } },
+		{ Autonomous::Play::SPY_BOT_SHOOT_REACH, 3, true, 2, { { SPY_SHOT_X, SPY_SHOT_Y, SPY_SHOT_HEADING }, { DEFENSE_FAR_X, START_Y[3], 0.0 } } },
+		{ Autonomous::Play::SPY_BOT_SHOOT_REACH, 4, true, 2, { { SPY_SHOT_X, SPY_SHOT_Y, SPY_SHOT_HEADING }, { DEFENSE_FAR_X, START_Y[4], 0.0 } } },
+		{ Autonomous::Play::SPY_BOT_SHOOT_REACH, 5, true, 2, { { SPY_SHOT_X, SPY_SHOT_Y, SPY_SHOT_HEADING }, { DEFENSE_FAR_X, START_Y[5], 0.0 } } }
+	};
+	const int ROUTE_COUNT = sizeof(ROUTES) / sizeof(*ROUTES);
+	static_assert(sizeof(ROUTES) / sizeof(*ROUTES) <= MAX_ROUTES, "too many routes");
+
+	uint32_t hash(uint32_t checksum, const void* data, size_t size);
+
+	int getRouteCount()
+	{
+		return ROUTE_COUNT;
+	}
+
+	const Route& getRoute(int index)
+	{
+		return ROUTES[index];
+	}
+
+	int findRoute(Autonomous::Play play, int position)
+	{
+		for (int i = 0; i < ROUTE_COUNT; ++i) {
+			if (ROUTES[i].play == play && ROUTES[i].position == position) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	bool generate(int index, ED::TrajectoryGenerator& generator, ED::Trajectory& trajectory)
+	{
+		const Route& route = ROUTES[index];
+		return generator.generateSpline(trajectory, route.waypoints, route.waypoint_count, route.reverse);
+	}
+
+	ED::TrajectoryGenerator::Limits getLimits()
+	{
+		return LIMITS;
+	}
+
+	float getPeriod()
+	{
+		return PERIOD;
+	}
+
+	uint32_t getChecksum()
+	{
+		// hash field by field, so that padding inside the structs doesn't count
+		uint32_t checksum = 2166136261u;
+		int version = ED::TrajectoryGenerator::VERSION;
+		checksum = hash(checksum, &version, sizeof(int));
+		checksum = hash(checksum, &LIMITS.max_velocity, sizeof(float));
+		checksum = hash(checksum, &LIMITS.max_acceleration, sizeof(float));
+		checksum = hash(checksum, &LIMITS.max_jerk, sizeof(float));
+		checksum = hash(checksum, &LIMITS.max_centripetal_acceleration, sizeof(float));
+		checksum = hash(checksum, &PERIOD, sizeof(float));
+		for (int i = 0; i < ROUTE_COUNT; ++i) {
+			const Route& route = ROUTES[i];
+			int play = route.play;
+			int reverse = route.reverse;
+			checksum = hash(checksum, &play, sizeof(int));
+			checksum = hash(checksum, &route.position, sizeof(int));
+			checksum = hash(checksum, &reverse, sizeof(int));
+			checksum = hash(checksum, &route.waypoint_count, sizeof(int));
+			for (int j = 0; j < route.waypoint_count; ++j) {
+				checksum = hash(checksum, &route.waypoints[j].x, sizeof(float));
+				checksum = hash(checksum, &route.waypoints[j].y, sizeof(float));
+				checksum = hash(checksum, &route.waypoints[j].heading, sizeof(float));
+			}
+		}
+		return checksum;
+	}
+
+	uint32_t hash(uint32_t checksum, const void* data, size_t size)
+	{
+		// 32 bit FNV-1a
+		const unsigned char* bytes = (const unsigned char*) data;
+		for (size_t i = 0; i < size; ++i) {
+			checksum ^= bytes[i];
+			checksum *= 16777619u;
+		}
+		return checksum;
+	}
+}
@@ -0,0 +1,71 @@
+#ifndef SRC_ROUTES_H_
+#define SRC_ROUTES_H_
+
+#include <Autonomous.hpp>
+#include <ED/TrajectoryGenerator.hpp>
+#include <stdint.h>
+
+/**
+ * The paths driven in autonomous, one for each play and starting position.
+ *
+ * Generating spline trajectories takes too long to do at the start of a
+ * match, so tools/TrajectoryBuilder generates every route ahead of time into
+ * a TrajectoryCache file, and Autonomous maps that file into memory when the
+ * robot boots.  Both use this file, so the routes only have to be written
+ * down once.  Nothing in here may depend on WPILib, because
+ * TrajectoryBuilder runs on a desktop.
+ *
+ * Positions are field coordinates, as used by Odometry.
+ */
+namespace Routes
+{
+	const int MAX_ROUTES = 32;
+
+	/**
+	 * The file on the roboRIO that holds the generated routes
+	 */
+	extern const char* const CACHE_PATH;
+
+	/*
+	 * Starting positions on the field.  Position 0 is the spy box, positions 1
+	 * through 5 are the defense slots, 1 being the low bar.
+	 */
+	const int START_POSITIONS = 6;
+	extern const float START_X[START_POSITIONS];
+	extern const float START_Y[START_POSITIONS];
+
+	struct Route {
+		Autonomous::Play play;
+		int position;
+		bool reverse; // whether the robot drives the route backwards
+		int waypoint_count;
+		ED::TrajectoryGenerator::Waypoint waypoints[ED::TrajectoryGenerator::MAX_WAYPOINTS];
+	};
+
+	int getRouteCount();
+	const Route& getRoute(int index);
+
+	/**
+	 * @return the index of the route for a play from a starting position, or
+	 *         -1 if that play doesn't drive anywhere from there
+	 */
+	int findRoute(Autonomous::Play play, int position);
+
+	/**
+	 * Generates the trajectory for a route
+	 * @return false if the route couldn't be generated
+	 */
+	bool generate(int index, ED::TrajectoryGenerator& generator, ED::Trajectory& trajectory);
+
+	ED::TrajectoryGenerator::Limits getLimits();
+	float getPeriod();
+
+	/**
+	 * Returns a checksum of every route and limit and of the generator version,
+	 * which changes whenever a route does, so that generated trajectories can be
+	 * checked for staleness
+	 */
+	uint32_t getChecksum();
+}
+
+#endif /* SRC_ROUTES_H_ */
@@ -1,8 +1,16 @@
+#include <atomic>
 #include <memory>
+#include <vector>
+#include <ED/SequenceLock.hpp>
+#include <Profiler.hpp>
 #include <Subsystems/Cameras.hpp>
 #include <Subsystems/ShooterPitch.hpp>
 #include <WPILib.h>
 
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
 using namespace std;
 
 namespace Cameras
@@ -22,6 +30,10 @@ namespace Cameras
 
 	const float HEIGHT_DISTANCE_RATIO = 46.25; // ratio of the target's pixel height to distance from the target in cm
 
+	const float HORIZONTAL_FIELD_OF_VIEW = 60.0; // degrees, TODO: measure actual field of view
+	const float PIPELINE_LATENCY = 0.1; // seconds between a frame being taken and GRIP publishing it, TODO: measure
+	const double GRIP_POLL_PERIOD = 0.02; // seconds between reads of GRIP's contours
+
 	struct Contour {
 		float x;
 		float y;
@@ -29,59 +41,118 @@ namespace Cameras
 		float width;
 		float height;
 	};
+	// the loop's copy, taken by refreshContours
 	Contour target;
+	bool goal_seen = false;
+	double target_timestamp = 0.0;
 
 	shared_ptr<NetworkTable> grip = NetworkTable::GetTable("GRIP");
 
+	// every read from GRIP copies a whole array into a new vector, so it's
+	// done on a thread of its own, which publishes the goal through a
+	// sequence lock
+	Notifier* grip_notifier;
+	Contour polled_target; // only touched by the GRIP thread
+	ED::SequenceLock target_lock;
+	std::atomic<bool> published_seen(false);
+	std::atomic<float> published_x(-1.0);
+	std::atomic<float> published_y(-1.0);
+	std::atomic<float> published_area(-1.0);
+	std::atomic<float> published_width(-1.0);
+	std::atomic<float> published_height(-1.0);
+	std::atomic<double> published_timestamp(0.0);
+
+	void pollGRIP();
+
 	void initialize()
 	{
-
+		grip_notifier = new Notifier(pollGRIP);
+		grip_notifier->StartPeriodic(GRIP_POLL_PERIOD);
 	}
 
 	void process()
 	{
-
+		refreshContours();
 	}
 
 	void refreshContours()
 	{
+		target_lock.read([]() {
+			goal_seen = published_seen.load(std::memory_order_relaxed);
+			target.x = published_x.load(std::memory_order_relaxed);
+			target.y = published_y.load(std::memory_order_relaxed);
+			target.area = published_area.load(std::memory_order_relaxed);
+			target.width = published_width.load(std::memory_order_relaxed);
+			target.height = published_height.load(std::memory_order_relaxed);
+			target_timestamp = published_timestamp.load(std::memory_order_relaxed);
+		});
+	}
+
+	void pollGRIP()
+	{
+		Profiler::Scope grip_scope(Profiler::GRIP_READ);
+
+		vector<double> center_x = grip->GetNumberArray("vision_contours/centerX", llvm::ArrayRef<double>());
+		vector<double> center_y = grip->GetNumberArray("vision_contours/centerY", llvm::ArrayRef<double>());
+		vector<double> area = grip->GetNumberArray("vision_contours/area", llvm::ArrayRef<double>());
+		vector<double> width = grip->GetNumberArray("vision_contours/width", llvm::ArrayRef<double>());
+		vector<double> height = grip->GetNumberArray("vision_contours/height", llvm::ArrayRef<double>());
+
+		// GRIP publishes the arrays one at a time, so they may not all be from the same frame yet
+		unsigned int count = center_x.size();
+		count = center_y.size() < count ? center_y.size() : count;
+		count = area.size() < count ? area.size() : count;
+		count = width.size() < count ? width.size() : count;
+		count = height.size() < count ? height.size() : count;
+
 		// find the highest contours
 		unsigned int index = 0;
-		float height = 0.0f;
-		for(unsigned int x = 0; x < grip->GetNumberArray("vision_contours/centerY", llvm::ArrayRef<double>()).size(); x++) {
-			if(grip->GetNumberArray("vision_contours/centerY", llvm::ArrayRef<double>())[x] > height) {
-				height = grip->GetNumberArray("vision_contours/centerY", llvm::ArrayRef<double>())[x];
+		float highest = 0.0f;
+		for (unsigned int x = 0; x < count; x++) {
+			if (center_y[x] > highest) {
+				highest = center_y[x];
 				index = x;
 			}
 		}
 
-		if(canSeeGoal()) {
-			target.x = grip->GetNumberArray("vision_contours/centerX", llvm::ArrayRef<double>())[index];
-			target.y = grip->GetNumberArray("vision_contours/centerY", llvm::ArrayRef<double>())[index];
-			target.area = grip->GetNumberArray("vision_contours/area", llvm::ArrayRef<double>())[index];
-			target.width = grip->GetNumberArray("vision_contours/width", llvm::ArrayRef<double>())[index];
-			target.height = grip->GetNumberArray("vision_contours/height", llvm::ArrayRef<double>())[index];
+		bool seen = count > 0;
+		double timestamp = published_timestamp.load(std::memory_order_relaxed);
+		if (seen) {
+			Contour last_target = polled_target;
+			polled_target.x = center_x[index];
+			polled_target.y = center_y[index];
+			polled_target.area = area[index];
+			polled_target.width = width[index];
+			polled_target.height = height[index];
+
+			// GRIP doesn't publish frame numbers, so a contour that moved at all is taken to be a new frame
+			if (polled_target.x != last_target.x || polled_target.y != last_target.y || polled_target.area != last_target.area) {
+				timestamp = Timer::GetFPGATimestamp() - PIPELINE_LATENCY;
+			}
 		}
 		else {
 			// none of these values should ever be negative, so use -1.0 as a default when no goal is seen
-			target.x = -1.0;
-			target.y = -1.0;
-			target.area = -1.0;
-			target.width = -1.0;
-			target.height = -1.0;
+			polled_target.x = -1.0;
+			polled_target.y = -1.0;
+			polled_target.area = -1.0;
+			polled_target.width = -1.0;
+			polled_target.height = -1.0;
 		}
+
+		target_lock.write([&]() {
+			published_seen.store(seen, std::memory_order_relaxed);
+			published_x.store(polled_target.x, std::memory_order_relaxed);
+			published_y.store(polled_target.y, std::memory_order_relaxed);
+			published_area.store(polled_target.area, std::memory_order_relaxed);
+			published_width.store(polled_target.width, std::memory_order_relaxed);
+			published_height.store(polled_target.height, std::memory_order_relaxed);
+			published_timestamp.store(timestamp, std::memory_order_relaxed);
+		});
 	}
 
 	bool canSeeGoal()
 	{
-		// do we have a contour area and location?
-		if(grip->GetNumberArray("vision_contours/area", llvm::ArrayRef<double>()).size() > 0 &&
-		   grip->GetNumberArray("vision_contours/centerX", llvm::ArrayRef<double>()).size() > 0 &&
-		   grip->GetNumberArray("vision_contours/centerY", llvm::ArrayRef<double>()).size() > 0) {
-
-			return true; // then return true
-		}
-		return false; // otherwise, return false
+		return goal_seen;
 	}
 
 	float getTargetX()
@@ -128,6 +199,20 @@ namespace Cameras
 		return 0.0;
 	}
 
+	float getTargetBearing()
+	{
+		if (canSeeGoal()) {
+			float focal_length = (IMAGE_WIDTH / 2.0) / tan(HORIZONTAL_FIELD_OF_VIEW / 2.0 * M_PI / 180.0); // pixels
+			return atan(getHorizontalPixelsFromTarget() / focal_length) * 180.0 / M_PI;
+		}
+		return 0.0;
+	}
+
+	double getTargetTimestamp()
+	{
+		return target_timestamp;
+	}
+
 	int getHorizontalPixelsFromTarget()
 	{
 		return (target.x - IMAGE_WIDTH / 2) - (getTargetWidth() / TARGET_WIDTH * CAMERA_SIDE_OFFSET);
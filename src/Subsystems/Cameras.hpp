@@ -7,7 +7,8 @@ namespace Cameras
 	void process();
 
 	/**
-	 * Updates the current tracking location with the latest information from the RPi
+	 * Updates the current tracking location with the latest information from the RPi,
+	 * as read from GRIP in the background
 	 */
 	void refreshContours();
 
@@ -31,6 +32,16 @@ namespace Cameras
 	float getDistanceFromTarget();
 	float getTargettingPitch();
 
+	/**
+	 * @return the angle in degrees from the front of the robot to the goal, positive to the right
+	 */
+	float getTargetBearing();
+
+	/**
+	 * @return the FPGA time in seconds at which the frame behind the current target was taken
+	 */
+	double getTargetTimestamp();
+
 	int getHorizontalPixelsFromTarget();
 
 	bool isTargettingEnabled();
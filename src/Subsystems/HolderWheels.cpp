@@ -20,7 +20,7 @@ namespace HolderWheels
 	{
 		wheels_motor = Utils::constructMotor(MotorPorts::HOLDER_WHEELS_MOTOR);
 		
-		shoot_timer = new Timer();
+		shoot_timer = Utils::constructTimer();
 		shoot_timer->Reset();
 	}
 
@@ -1,3 +1,6 @@
+#include <CANTalon.h>
+#include <ED/ClosedLoopActuator.hpp>
+#include <ED/MotionProfile.hpp>
 #include <ED/PIDManager.hpp>
 #include <Ports/Motor.hpp>
 #include <Subsystems/IntakeAngle.hpp>
@@ -6,12 +9,33 @@
 #include <Utils.hpp>
 #include <WPILib.h>
 
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+const float GRAVITY_FEED_FORWARD = 0.05; // output that holds the arm level, TODO: measure
+const float VELOCITY_FEED_FORWARD = 1.0 / 360.0; // output per degree per second, TODO: measure
+const float DERIVATIVE_FILTER_TIME = 0.02; // seconds, so pot noise doesn't reach the motor, TODO: tune
+const float BACK_CALCULATION_TIME = 0.2; // seconds to unwind the integral term while the motor is saturated, TODO: tune
+
 class IntakeAnglePID : public ED::PIDManager
 {
 public:
-	IntakeAnglePID() : PIDManager(0.02, 0.0001, 0.0)
+	IntakeAnglePID() : PIDManager(0.02, 0.0001, 0.0, GRAVITY_FEED_FORWARD)
 	{
 		autoClearAccumulatedError(true);
+		setDerivativeFilter(DERIVATIVE_FILTER_TIME);
+		setBackCalculation(-1.0, 1.0, BACK_CALCULATION_TIME);
+	}
+
+	/**
+	 * Sets the target to a point along a motion profile, so that the
+	 * feed-forward can include how fast the arm should be moving
+	 */
+	void setProfiledTarget(float angle, float velocity)
+	{
+		profile_velocity = velocity;
+		setTarget(angle);
 	}
 
 protected:
@@ -20,10 +44,19 @@ protected:
 		return Sensors::getIntakeAngle();
 	}
 
+	float getFeedForwardOutput(float new_target)
+	{
+		// gravity pulls hardest on the arm when it's level
+		return getF() * cos(new_target * M_PI / 180.0) + VELOCITY_FEED_FORWARD * profile_velocity;
+	}
+
 	void usePIDOutput(float output, float feed_forward)
 	{
-		IntakeAngle::setSpeed(output);
+		IntakeAngle::setSpeed(output + feed_forward);
 	}
+
+private:
+	float profile_velocity = 0.0;
 };
 
 namespace IntakeAngle
@@ -31,6 +64,23 @@ namespace IntakeAngle
 	const float MOTOR_SPEED = 0.5;
 	const float ACCEPTABLE_ERROR = 5.0;
 	
+	// limits for moving between angles with the PID
+	const float MAX_VELOCITY = 180.0; // degrees per second
+	const float MAX_ACCELERATION = 720.0; // degrees per second squared
+	const float MAX_JERK = 7200.0; // degrees per second cubed
+	
+	// used when the arm has a CANTalon, which then runs the PID itself from the
+	// encoder wired to its analog input, 0 - 1023 across 0.0 - 3.3 volts, TODO:
+	// the intake encoder is shifted and flipped on the roboRIO, so measure
+	// the offset once it's wired to the Talon
+	const ED::ClosedLoopActuator::Config TALON_CONFIG = {
+		ED::ClosedLoopActuator::Mode::POSITION,
+		CANTalon::AnalogEncoder,
+		true,
+		(3.72 - 2.5) / 90.0 * 1023.0 / 3.3, // per degree
+		0.0
+	};
+	
 	const float ANGLE_PRESETS[] = {
 		-30.0,
 		-15.0,
@@ -44,6 +94,11 @@ namespace IntakeAngle
 
 	IntakeAnglePID* pid_manager = nullptr;
 	SpeedController* angle_motor = nullptr;
+	ED::ClosedLoopActuator* angle_actuator = nullptr;
+	
+	ED::MotionProfile* angle_profile;
+	double profile_start_time = 0.0;
+	float goal_angle = 0.0;
 	
 	void setState(State new_state);
 
@@ -51,6 +106,9 @@ namespace IntakeAngle
 	{
 		pid_manager = new IntakeAnglePID();
 		angle_motor = Utils::constructMotor(MotorPorts::INTAKE_ANGLE_MOTOR);
+		angle_actuator = new ED::ClosedLoopActuator(angle_motor, pid_manager, TALON_CONFIG);
+		
+		angle_profile = new ED::MotionProfile();
 	}
 
 	void process()
@@ -58,17 +116,18 @@ namespace IntakeAngle
 		switch (state) {
 		case State::DISABLED:
 		case State::WAITING:
-			pid_manager->enable(false);
+			angle_actuator->enable(false);
 			setSpeed(0.0);
 			break;
 			
 		case State::MANUAL_CONTROL:
-			pid_manager->enable(false);
+			angle_actuator->enable(false);
 			break;
 			
 		case State::REACHING_ANGLE:
-			if (!pid_manager->isEnabled()) {
-				float error = pid_manager->getTarget() - Sensors::getIntakeAngle();
+			if (!angle_actuator->isEnabled()) {
+				float angle = Sensors::getIntakeAngle();
+				float error = goal_angle - angle;
 				if (fabs(error) > ACCEPTABLE_ERROR) {
 					if (error > 0) {
 						setDirection(Utils::VerticalDirection::UP);
@@ -78,8 +137,9 @@ namespace IntakeAngle
 					}
 				}
 				else {
-					// this will probably lead to the intake jerking up over and over again, trying to stay in the zone
-					setDirection(Utils::VerticalDirection::V_STILL);
+					// hold the arm against gravity, rather than letting it sag out of
+					// the zone and jerking it back up over and over
+					setSpeed(pid_manager->getF() * cos(angle * M_PI / 180.0));
 				}
 			}
 			break;
@@ -88,12 +148,21 @@ namespace IntakeAngle
 
 	void processPID()
 	{
-		pid_manager->process();
+		if (state == State::REACHING_ANGLE && angle_actuator->isEnabled()) {
+			ED::MotionProfile::State setpoint = angle_profile->sample(Timer::GetFPGATimestamp() - profile_start_time);
+			pid_manager->setProfiledTarget(setpoint.position, setpoint.velocity);
+		}
+		angle_actuator->process();
+	}
+
+	ED::PIDManager* getPIDManager()
+	{
+		return pid_manager;
 	}
 
 	void enablePID(bool enable)
 	{
-		pid_manager->enable(enable);
+		angle_actuator->enable(enable);
 	}
 
 	void setSpeed(float speed)
@@ -137,20 +206,31 @@ namespace IntakeAngle
 	
 	void engageManualControl()
 	{
-		pid_manager->enable(false);
+		angle_actuator->enable(false);
 		setState(State::MANUAL_CONTROL);
 	}
 	
 	void goToAngle(float degrees)
 	{
-		pid_manager->setTarget(degrees);
-		pid_manager->enable(OI::isPIDEnabled());
+		// start from the setpoint of a move that's still under way, so that the
+		// target doesn't jump back to where the arm has lagged to
+		float start = Sensors::getIntakeAngle();
+		if (state == State::REACHING_ANGLE && angle_actuator->isEnabled()) {
+			start = pid_manager->getTarget();
+		}
+		
+		goal_angle = degrees;
+		angle_profile->plan(start, degrees - start, MAX_VELOCITY, MAX_ACCELERATION, MAX_JERK);
+		profile_start_time = Timer::GetFPGATimestamp();
+		
+		pid_manager->setProfiledTarget(start, 0.0);
+		angle_actuator->enable(OI::isPIDEnabled());
 		setState(State::REACHING_ANGLE);
 	}
 	
 	void interrupt()
 	{
-		pid_manager->enable(false);
+		angle_actuator->enable(false);
 		setState(State::WAITING);
 	}
 	
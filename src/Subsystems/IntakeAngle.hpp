@@ -3,6 +3,11 @@
 
 #include <Utils.hpp>
 
+namespace ED
+{
+	class PIDManager;
+}
+
 namespace IntakeAngle
 {
 	enum State {
@@ -16,6 +21,7 @@ namespace IntakeAngle
 	void process();
 	void processPID();
 	void enablePID(bool enable);
+	ED::PIDManager* getPIDManager();
 
 	/**
 	 * Sets the turn rate of the intake arm.  Positive speeds move the arm up,
@@ -1,32 +1,109 @@
+#include <ED/DriveController.hpp>
+#include <ED/MotionProfile.hpp>
+#include <ED/Trajectory.hpp>
+#include <ED/TrajectoryGenerator.hpp>
 #include <ED/Utils.hpp>
 #include <Ports/Motor.hpp>
-#include <math.h>
 #include <Subsystems/Mobility.hpp>
+#include <Subsystems/Odometry.hpp>
+#include <Subsystems/PowerBudget.hpp>
 #include <Subsystems/Sensors.hpp>
 #include <Utils.hpp>
 #include <WPILib.h>
 
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
 namespace Mobility
 {
 	const float ACCEPTABLE_ANGLE_ERROR = 1.0;
-	const float ACCEPTABLE_DIST_ERROR = 5.0;
-	
-	const float MAX_SPEED_ADJUSTMENT = 3.2;
+
+	/*
+	 * Limits for moves planned by Mobility itself, like driveDistance
+	 */
+	const float MAX_VELOCITY = 300.0; // cm/s
+	const float MAX_ACCELERATION = 250.0; // cm/s^2
+	const float MAX_JERK = 1500.0; // cm/s^3
+	const float MAX_CENTRIPETAL_ACCELERATION = 150.0; // cm/s^2
+	const float TRAJECTORY_PERIOD = 0.01; // seconds
+
+	const float MAX_TURN_RATE = 180.0; // degrees per second
+	const float MAX_TURN_ACCELERATION = 360.0; // degrees per second^2
+
+	/*
+	 * Guesses at the drive gains, until the drive train is characterized
+	 */
+	const DriveGains DEFAULT_DRIVE_GAINS = {
+		0.06, // ks
+		0.0025, // kv
+		0.0004, // ka
+		66.0 // effective wheelbase
+	};
+
+	/*
+	 * The state-space controller behind every move Mobility makes itself.  Its
+	 * gain comes from the drive gains, so these only say how much error is too
+	 * much and how far each sensor can be trusted.
+	 */
+	ED::DriveController::Config getControllerConfig()
+	{
+		ED::DriveController::Config config;
+		config.max_speed_error = 30.0;
+		config.max_heading_error = 2.0;
+		config.max_output = 0.3;
+		config.period = 0.005;
+
+		config.speed_noise = 2500.0;
+		config.heading_noise = 1.0;
+
+		config.encoder_speed_noise = 5.0;
+		config.gyro_rate_noise = 2.0;
+		config.gyro_angle_noise = 0.5;
+		return config;
+	}
+
+	/*
+	 * Gains for the Ramsete controller, which steers the robot back onto the
+	 * trajectory when it strays.  RAMSETE_B is like a proportional gain on
+	 * position error, and RAMSETE_ZETA is like a damping ratio.
+	 */
+	const float RAMSETE_B = 0.0002; // 1/cm^2
+	const float RAMSETE_ZETA = 0.7;
 	
 	SpeedController* left_motor1;
 	SpeedController* left_motor2;
 	SpeedController* right_motor1;
 	SpeedController* right_motor2;
 
+	ED::TrajectoryGenerator* generator;
+	ED::Trajectory* distance_trajectory;
+	ED::Trajectory* spare_trajectory; // generated into, so a failure can't spoil the move underway
+	ED::MotionProfile* turn_profile;
+	ED::DriveController* drive_controller;
+
 	State state = State::WAITING;
 
+	DriveGains drive_gains = DEFAULT_DRIVE_GAINS;
+
 	bool normal_orientation = true;
 	float target_angle = 0.0;
 	float target_speed = 0.0;
-	float left_target_dist = 0.0;
-	float right_target_dist = 0.0;
+
+	const ED::Trajectory* trajectory = nullptr;
+	double trajectory_start_time = 0.0;
+
+	// what last reached each side of the drive train, towards the physical front
+	float left_output = 0.0;
+	float right_output = 0.0;
+	double last_update_time = 0.0;
 
 	void setState(State new_state);
+	void updateController();
+	void trackTrajectory();
+	void trackTurn();
+	void driveController(float left_speed, float right_speed, float left_acceleration, float right_acceleration, float heading);
+	float toPhysical(float value);
 
 	void initialize()
 	{
@@ -34,18 +111,33 @@ namespace Mobility
 		left_motor2 = Utils::constructMotor(MotorPorts::LEFT_MOTOR2);
 		right_motor1 = Utils::constructMotor(MotorPorts::RIGHT_MOTOR1);
 		right_motor2 = Utils::constructMotor(MotorPorts::RIGHT_MOTOR2);
+
+		ED::TrajectoryGenerator::Limits limits = {
+			MAX_VELOCITY,
+			MAX_ACCELERATION,
+			MAX_JERK,
+			MAX_CENTRIPETAL_ACCELERATION
+		};
+		generator = new ED::TrajectoryGenerator(limits, TRAJECTORY_PERIOD);
+		distance_trajectory = new ED::Trajectory();
+		spare_trajectory = new ED::Trajectory();
+		turn_profile = new ED::MotionProfile();
+		drive_controller = new ED::DriveController(getControllerConfig(), drive_gains);
+		last_update_time = Timer::GetFPGATimestamp();
 	}
 
 	void process()
 	{
-		float left_dist;
-		float right_dist;
+		updateController();
+
 		switch (state) {
 		case State::DISABLED:
 			left_motor1->Set(0.0);
 			left_motor2->Set(0.0);
 			right_motor1->Set(0.0);
 			right_motor2->Set(0.0);
+			left_output = 0.0;
+			right_output = 0.0;
 			break;
 		
 		case State::WAITING:
@@ -53,21 +145,18 @@ namespace Mobility
 			break;
 			
 		case State::DRIVE_DISTANCE:
-			left_dist = Sensors::getLeftEncoderDistance();
-			right_dist = Sensors::getRightEncoderDistance();
+		case State::FOLLOW_TRAJECTORY:
+			trackTrajectory();
+			break;
+			
+		case State::TURN_TO_HEADING:
+			trackTurn();
+			break;
 			
-			if (fabs(left_dist - left_target_dist) < ACCEPTABLE_DIST_ERROR && fabs(right_dist - right_target_dist) < ACCEPTABLE_DIST_ERROR) {
-				setState(State::WAITING);
-				break;
-			}
-			else {
-				target_speed = ED::boundsCheck(((left_target_dist - left_dist) + (right_target_dist - right_dist)) / 2.0, -1.0, 1.0);
-			}
 		case State::DRIVE_STRAIGHT:
-			float adjusted_speed = MAX_SPEED_ADJUSTMENT *
-			    ED::getRelative(Sensors::getRobotAngle(), target_angle, Sensors::MIN_GYRO_ANGLE, Sensors::MAX_GYRO_ANGLE) / 180.0;
-			setLeftSpeed(target_speed - adjusted_speed);
-			setRightSpeed(target_speed + adjusted_speed);
+			// the output is a fraction of top speed, the speed full output holds
+			float speed = toPhysical(target_speed) * (1.0 - drive_gains.ks) / drive_gains.kv;
+			driveController(speed, speed, 0.0, 0.0, target_angle);
 			break;
 		}
 	}
@@ -82,9 +171,24 @@ namespace Mobility
 		return normal_orientation;
 	}
 
+	void setDriveGains(const DriveGains& gains)
+	{
+		drive_gains = gains;
+		if (!drive_controller->setModel(gains)) {
+			DriverStation::ReportError("couldn't find a drive controller gain for the new drive gains, keeping the last one");
+		}
+	}
+
+	DriveGains getDriveGains()
+	{
+		return drive_gains;
+	}
+
 	void setLeftSpeed(float speed)
 	{
 		if (state != State::DISABLED) {
+			speed *= PowerBudget::getScale(PowerBudget::Consumer::MOBILITY);
+			left_output = toPhysical(speed);
 			speed = normal_orientation ? speed : -speed;
 			left_motor1->Set(speed);
 			left_motor2->Set(speed);
@@ -94,6 +198,8 @@ namespace Mobility
 	void setRightSpeed(float speed)
 	{
 		if (state != State::DISABLED) {
+			speed *= PowerBudget::getScale(PowerBudget::Consumer::MOBILITY);
+			right_output = toPhysical(speed);
 			speed = normal_orientation ? -speed : speed;
 			right_motor1->Set(speed);
 			right_motor2->Set(speed);
@@ -113,19 +219,47 @@ namespace Mobility
 	
 	void driveStraight(float speed)
 	{
-		target_angle = Sensors::getRobotAngle();
+		// driveStraight is called every loop while the button is held, so the
+		// heading is only latched on the way in, or there'd be nothing to hold
+		if (state != State::DRIVE_STRAIGHT) {
+			target_angle = drive_controller->getHeading();
+		}
 		target_speed = speed;
 		setState(State::DRIVE_STRAIGHT);
 	}
 	
 	void driveDistance(float distance)
 	{
-		left_target_dist = Sensors::getLeftEncoderDistance() + distance;
-		right_target_dist = Sensors::getRightEncoderDistance() + distance;
-		target_angle = Sensors::getRobotAngle();
+		Odometry::Pose pose = Odometry::getPose();
+		ED::TrajectoryGenerator::Waypoint start = { pose.x, pose.y, pose.heading };
+		if (!generator->generateStraight(*spare_trajectory, start, toPhysical(distance))) {
+			DriverStation::ReportError("couldn't plan the distance to drive");
+			return;
+		}
+
+		ED::Trajectory* generated = spare_trajectory;
+		spare_trajectory = distance_trajectory;
+		distance_trajectory = generated;
+		trajectory = distance_trajectory;
+		trajectory_start_time = Timer::GetFPGATimestamp();
 		setState(State::DRIVE_DISTANCE);
 	}
 	
+	void followTrajectory(const ED::Trajectory* trajectory)
+	{
+		Mobility::trajectory = trajectory;
+		trajectory_start_time = Timer::GetFPGATimestamp();
+		setState(State::FOLLOW_TRAJECTORY);
+	}
+	
+	void turnToHeading(float heading)
+	{
+		float current_heading = Odometry::getHeading();
+		turn_profile->plan(current_heading, heading - current_heading, MAX_TURN_RATE, MAX_TURN_ACCELERATION, 0.0);
+		trajectory_start_time = Timer::GetFPGATimestamp();
+		setState(State::TURN_TO_HEADING);
+	}
+	
 	void interrupt()
 	{
 		setState(State::WAITING);
@@ -136,6 +270,92 @@ namespace Mobility
 		return state;
 	}
 	
+	void trackTrajectory()
+	{
+		float time = Timer::GetFPGATimestamp() - trajectory_start_time;
+		if (time >= trajectory->getDuration()) {
+			setState(State::WAITING);
+			return;
+		}
+
+		ED::Trajectory::Sample goal = trajectory->sample(time);
+		Odometry::Pose pose = Odometry::getPose();
+
+		// how far the goal is ahead of the robot, to its right, and clockwise from it
+		float heading = pose.heading * M_PI / 180.0;
+		float x_error = goal.x - pose.x;
+		float y_error = goal.y - pose.y;
+		float forward_error = cos(heading) * x_error + sin(heading) * y_error;
+		float right_error = -sin(heading) * x_error + cos(heading) * y_error;
+		float heading_error = ED::wrap((goal.heading - pose.heading) * M_PI / 180.0, -M_PI, M_PI);
+
+		// Ramsete: correct the speed for the error ahead, and the turn rate for
+		// the error in heading and to the side
+		float goal_turn_rate = goal.velocity * goal.curvature; // radians per second
+		float gain = 2.0 * RAMSETE_ZETA * sqrt(goal_turn_rate * goal_turn_rate + RAMSETE_B * goal.velocity * goal.velocity);
+		float sinc = fabs(heading_error) > 0.0001 ? sin(heading_error) / heading_error : 1.0;
+		float speed = goal.velocity * cos(heading_error) + gain * forward_error;
+		float turn_rate = goal_turn_rate + gain * heading_error + RAMSETE_B * goal.velocity * sinc * right_error;
+
+		// turning clockwise speeds up the left side; Ramsete already steers, so
+		// the controller holds the heading it's at
+		float left_speed = speed + turn_rate * drive_gains.wheelbase / 2.0;
+		float right_speed = speed - turn_rate * drive_gains.wheelbase / 2.0;
+		driveController(left_speed, right_speed, goal.acceleration, goal.acceleration, drive_controller->getHeading());
+	}
+
+	void trackTurn()
+	{
+		float time = Timer::GetFPGATimestamp() - trajectory_start_time;
+		float heading = Odometry::getHeading();
+		if (time >= turn_profile->getDuration() && fabs(turn_profile->getEnd() - heading) < ACCEPTABLE_ANGLE_ERROR) {
+			setState(State::WAITING);
+			return;
+		}
+
+		ED::MotionProfile::State goal = turn_profile->sample(time);
+		float wheel_speed = goal.velocity * M_PI / 180.0 * drive_gains.wheelbase / 2.0;
+		float wheel_acceleration = goal.acceleration * M_PI / 180.0 * drive_gains.wheelbase / 2.0;
+
+		// the profile is planned in Odometry's headings, which can be offset
+		// from the controller's, so only its error carries over
+		float goal_heading = drive_controller->getHeading() + goal.position - heading;
+
+		// turning clockwise speeds up the left side
+		driveController(wheel_speed, -wheel_speed, wheel_acceleration, -wheel_acceleration, goal_heading);
+	}
+
+	void updateController()
+	{
+		double timestamp = Timer::GetFPGATimestamp();
+		ED::DriveController::Measurement measurement = {
+			toPhysical(Sensors::getLeftEncoderSpeed()),
+			toPhysical(Sensors::getRightEncoderSpeed()),
+			Sensors::areDriveEncodersEnabled(),
+			Sensors::getRobotTurnRate(),
+			Sensors::getContinuousRobotAngle(),
+			Sensors::isGyroEnabled()
+		};
+		drive_controller->update(timestamp - last_update_time, left_output, right_output, measurement);
+		last_update_time = timestamp;
+	}
+
+	void driveController(float left_speed, float right_speed, float left_acceleration, float right_acceleration, float heading)
+	{
+		float left;
+		float right;
+		drive_controller->calculate(left_speed, right_speed, left_acceleration, right_acceleration, heading, left, right);
+		setLeftSpeed(toPhysical(left));
+		setRightSpeed(toPhysical(right));
+	}
+
+	float toPhysical(float value)
+	{
+		// converts between the physical front of the robot and the front in use,
+		// which works in both directions
+		return normal_orientation ? value : -value;
+	}
+	
 	void setState(State new_state)
 	{
 		if (state != new_state) {
@@ -149,6 +369,8 @@ namespace Mobility
 			case State::MANUAL_CONTROL:
 			case State::DRIVE_STRAIGHT:
 			case State::DRIVE_DISTANCE:
+			case State::FOLLOW_TRAJECTORY:
+			case State::TURN_TO_HEADING:
 				setLeftSpeed(0.0);
 				setRightSpeed(0.0);
 				break;
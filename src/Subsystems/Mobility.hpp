@@ -1,14 +1,32 @@
 #ifndef SRC_MOBILITY_H_
 #define SRC_MOBILITY_H_
 
+#include <ED/DriveCharacterizer.hpp>
+
+namespace ED
+{
+	class Trajectory;
+}
+
 namespace Mobility
 {
+	/*
+	 * The feedforward from the speed of one side of the drive train to its
+	 * motor output, and the distance between the left and right wheels, as far
+	 * as turning is concerned.  Skid steer drive trains scrub when they turn,
+	 * which makes them act wider than they measure.  Characterization finds
+	 * these in test mode.
+	 */
+	typedef ED::DriveCharacterizer::Gains DriveGains;
+
 	enum State {
 		DISABLED,
 		WAITING,
 		MANUAL_CONTROL,
 		DRIVE_STRAIGHT,
-		DRIVE_DISTANCE
+		DRIVE_DISTANCE,
+		FOLLOW_TRAJECTORY,
+		TURN_TO_HEADING
 	};
 	
 	void initialize();
@@ -28,6 +46,9 @@ namespace Mobility
 	 */
 	bool usingNormalOrientation();
 
+	void setDriveGains(const DriveGains& gains);
+	DriveGains getDriveGains();
+
 	void setLeftSpeed(float speed);
 	void setRightSpeed(float speed);
 
@@ -40,15 +61,35 @@ namespace Mobility
 
 	/**
 	 * Drives at the given speed while attempting to keep the robot pointed in
-	 * the same direction
+	 * the direction it faced when it started driving straight.  Calling it
+	 * again while driving straight only changes the speed.
 	 */
 	void driveStraight(float speed);
 
 	/**
 	 * Drives a specific distance in centimeters while attempting to keep the
-	 * robot pointed in the same direction
+	 * robot pointed in the same direction, speeding up and slowing down
+	 * smoothly.  The state returns to WAITING when the move is finished.
 	 */
 	void driveDistance(float centimeters);
+
+	/**
+	 * Drives along a trajectory made by ED::TrajectoryGenerator, starting now.
+	 * The trajectory is in field coordinates, so Odometry must know where the
+	 * robot is, and it must stay in memory until it's finished.  The state
+	 * returns to WAITING at the end of the trajectory.
+	 *
+	 * Trajectories are in terms of the physical front of the robot, the side
+	 * the shooter faces, no matter which orientation is in use.
+	 */
+	void followTrajectory(const ED::Trajectory* trajectory);
+
+	/**
+	 * Turns in place to face a heading on the field, as measured by Odometry.
+	 * Headings are continuous, so turning to 360 from 0 makes a full turn.  The
+	 * state returns to WAITING once the robot is facing the heading.
+	 */
+	void turnToHeading(float heading);
 	void interrupt();
 	State getState();
 }
@@ -1,5 +1,6 @@
-#include <ED/Utils.hpp>
 #include <Coordination.hpp>
+#include <ED/InputSnapshot.hpp>
+#include <ED/Utils.hpp>
 #include <Ports/OI.hpp>
 #include <Subsystems/ClimberArm.hpp>
 #include <Subsystems/HolderWheels.hpp>
@@ -18,21 +19,16 @@ namespace OI
 {
 	const float JOYSTICK_DEADZONE = 0.1;
 	
-	Joystick* left_joy;
-	Joystick* right_joy;
-	
-	Joystick* buttons_joy1;
-	Joystick* buttons_joy2;
+	ED::InputSnapshot* inputs;
 	
 	bool last_pid_switch = false;
-	bool last_shooter_wheels_switch = false;
 	int last_intake_angle_dial = -1;
 	int last_shooter_pitch_dial = -1;
 	int last_shooter_wheels_dial = -1;
 	Utils::VerticalDirection last_intake_angle_dir = Utils::VerticalDirection::V_STILL;
 	Utils::HorizontalDirection last_intake_roller_dir = Utils::HorizontalDirection::H_STILL;
 
-	float getJoystickAnalogPort(Joystick* joy, unsigned int port, float deadzone = 0.0);
+	float getJoystickAnalogPort(unsigned int joy, unsigned int port, float deadzone = 0.0);
 	
 	void mobilityProcess();
 	void intakeProcess(); // includes HolderWheels
@@ -42,16 +38,15 @@ namespace OI
 	
 	void initialize()
 	{
-		right_joy = new Joystick(OIPorts::RIGHT_JOYSTICK);
-		left_joy = new Joystick(OIPorts::LEFT_JOYSTICK);
-		
-		buttons_joy1 = new Joystick(OIPorts::BUTTONS_JOYSTICK1);
-		buttons_joy2 = new Joystick(OIPorts::BUTTONS_JOYSTICK2);
+		inputs = new ED::InputSnapshot();
+		inputs->capture();
 	}
 	
 	void process()
 	{
-		bool sensor_switch = buttons_joy1->GetRawButton(OIPorts::SENSOR_ENABLE_SWITCH);
+		captureInputs();
+		
+		bool sensor_switch = inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::SENSOR_ENABLE_SWITCH);
 		Sensors::enableGyro(sensor_switch);
 		Sensors::enableShooterAngle(sensor_switch);
 		Sensors::enableIntakeAngle(sensor_switch);
@@ -65,12 +60,12 @@ namespace OI
 		////// PID & Sensor enable //////
 		bool pid_switch;
 		if (sensor_switch) {
-			pid_switch = buttons_joy1->GetRawButton(OIPorts::PID_ENABLE_SWITCH);
+			pid_switch = inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::PID_ENABLE_SWITCH);
 		}
 		else {
 			pid_switch = false;
 		}
-		if (pid_switch != pid_switch) {
+		if (pid_switch != last_pid_switch) {
 			IntakeAngle::enablePID(pid_switch);
 			ShooterPitch::enablePID(pid_switch);
 			ShooterWheels::enablePID(pid_switch);
@@ -85,30 +80,51 @@ namespace OI
 		climberProcess();
 	}
 	
+	void captureInputs()
+	{
+		inputs->capture();
+	}
+	
+	const ED::InputSnapshot& getInputs()
+	{
+		return *inputs;
+	}
+	
 	bool isPIDEnabled()
 	{
-		return buttons_joy1->GetRawButton(OIPorts::PID_ENABLE_SWITCH);
+		return inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::PID_ENABLE_SWITCH);
 	}
 	
-	float getJoystickAnalogPort(Joystick* joy, unsigned int port, float deadzone)
+	bool isProfileReportRequested()
 	{
-		float joy_value = -joy->GetRawAxis(port);
+		return inputs->wasPressed(OIPorts::BUTTONS_JOYSTICK2, OIPorts::PROFILE_REPORT_BUTTON);
+	}
+	
+	float getJoystickAnalogPort(unsigned int joy, unsigned int port, float deadzone)
+	{
+		float joy_value = -inputs->getAxis(joy, port);
 		
 		if (deadzone != 0.0 && ED::valueInRange(joy_value, -deadzone, deadzone)) {
 			return 0.0;
 		}
 		
-		return -joy->GetRawAxis(port);
+		return joy_value;
 	}
 	
 	void mobilityProcess()
 	{
-		float left_joy_speed = getJoystickAnalogPort(left_joy, OIPorts::JOYSTICK_Y_PORT, JOYSTICK_DEADZONE);
-		float right_joy_speed = getJoystickAnalogPort(right_joy, OIPorts::JOYSTICK_X_PORT, JOYSTICK_DEADZONE);
-		if (left_joy->GetRawButton(OIPorts::B_DRIVE_STRAIGHT_LEFT)) {
+		// leave the drive train alone while Coordination is aiming with it
+		if (Coordination::getState() == Coordination::State::AUTO_AIM ||
+		    Coordination::getState() == Coordination::State::AUTO_SHOOT) {
+			return;
+		}
+		
+		float left_joy_speed = getJoystickAnalogPort(OIPorts::LEFT_JOYSTICK, OIPorts::JOYSTICK_Y_PORT, JOYSTICK_DEADZONE);
+		float right_joy_speed = getJoystickAnalogPort(OIPorts::RIGHT_JOYSTICK, OIPorts::JOYSTICK_X_PORT, JOYSTICK_DEADZONE);
+		if (inputs->getButton(OIPorts::LEFT_JOYSTICK, OIPorts::B_DRIVE_STRAIGHT_LEFT)) {
 			Mobility::driveStraight(left_joy_speed);
 		}
-		else if (right_joy->GetRawButton(OIPorts::B_DRIVE_STRAIGHT_RIGHT)) {
+		else if (inputs->getButton(OIPorts::RIGHT_JOYSTICK, OIPorts::B_DRIVE_STRAIGHT_RIGHT)) {
 			Mobility::driveStraight(right_joy_speed);
 		}
 		else {
@@ -120,13 +136,13 @@ namespace OI
 	
 	void intakeProcess()
 	{
-		int dial = ED::convertVoltage(getJoystickAnalogPort(buttons_joy1, OIPorts::INTAKE_ANGLE_DIAL) + 1.0, IntakeAngle::getPresetCount(), 2.0);
+		int dial = ED::convertVoltage(getJoystickAnalogPort(OIPorts::BUTTONS_JOYSTICK1, OIPorts::INTAKE_ANGLE_DIAL) + 1.0, IntakeAngle::getPresetCount(), 2.0);
 		
 		Utils::VerticalDirection intake_angle_dir = Utils::VerticalDirection::V_STILL;
-		if (buttons_joy1->GetRawButton(OIPorts::MOVE_INTAKE_UP_BUTTON)) {
+		if (inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::MOVE_INTAKE_UP_BUTTON)) {
 			intake_angle_dir = Utils::VerticalDirection::UP;
 		}
-		else if (buttons_joy1->GetRawButton(OIPorts::MOVE_INTAKE_DOWN_BUTTON)) {
+		else if (inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::MOVE_INTAKE_DOWN_BUTTON)) {
 			intake_angle_dir = Utils::VerticalDirection::DOWN;
 		}
 		else {
@@ -156,14 +172,14 @@ namespace OI
 			break;
 		}
 		
-		if (buttons_joy1->GetRawButton(OIPorts::INTAKE_BELT_INWARD_SWITCH)) {
+		if (inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::INTAKE_BELT_INWARD_SWITCH)) {
 			last_intake_roller_dir = Utils::HorizontalDirection::IN;
 
 			HolderWheels::engageManualControl();
 			HolderWheels::setDirection(last_intake_roller_dir);
 			IntakeRoller::setDirection(last_intake_roller_dir);
 		}
-		else if (buttons_joy1->GetRawButton(OIPorts::INTAKE_BELT_OUTWARD_SWITCH)) {
+		else if (inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::INTAKE_BELT_OUTWARD_SWITCH)) {
 			last_intake_roller_dir = Utils::HorizontalDirection::OUT;
 
 			HolderWheels::engageManualControl();
@@ -185,7 +201,7 @@ namespace OI
 	void shooterPitchProcess()
 	{
 		////// Shooter pitch dial //////
-		int dial = ED::convertVoltage(getJoystickAnalogPort(buttons_joy1, OIPorts::SHOOTER_PITCH_DIAL) + 1.0, ShooterPitch::getPresetCount(), 2.0);
+		int dial = ED::convertVoltage(getJoystickAnalogPort(OIPorts::BUTTONS_JOYSTICK1, OIPorts::SHOOTER_PITCH_DIAL) + 1.0, ShooterPitch::getPresetCount(), 2.0);
 		if (dial != last_shooter_pitch_dial) { // if the dial has been moved
 			ShooterPitch::goToAngle(ShooterPitch::getAnglePreset(dial));
 			
@@ -195,10 +211,10 @@ namespace OI
 	
 	void shooterWheelsProcess()
 	{
-		bool shooter_switch = buttons_joy1->GetRawButton(OIPorts::SHOOTER_WHEELS_SWITCH);
+		bool shooter_switch = inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::SHOOTER_WHEELS_SWITCH);
 		
 		// the current position of the shooter dial
-		int dial = ED::convertVoltage(getJoystickAnalogPort(buttons_joy1, OIPorts::SHOOTER_SPEED_DIAL) + 1.0, ShooterWheels::getPresetCount(), 2.0);
+		int dial = ED::convertVoltage(getJoystickAnalogPort(OIPorts::BUTTONS_JOYSTICK1, OIPorts::SHOOTER_SPEED_DIAL) + 1.0, ShooterWheels::getPresetCount(), 2.0);
 		
 		float speed; // is used later for the shoot button as well; might refer to either `rate` or `speed`
 		if (Sensors::isShooterTachEnabled()) {
@@ -221,27 +237,41 @@ namespace OI
 				last_shooter_wheels_dial = dial;
 			}
 		}
-		else if (last_shooter_wheels_switch) { // if the switch was just turned off
+		else if (inputs->wasReleased(OIPorts::BUTTONS_JOYSTICK1, OIPorts::SHOOTER_WHEELS_SWITCH)) {
 			ShooterWheels::setSpeed(0.0);
 			last_shooter_wheels_dial = -1; // forces a shooter update when the switch is turned back on
 		}
-		last_shooter_wheels_switch = shooter_switch;
 		
-		if (buttons_joy1->GetRawButton(OIPorts::SHOOT_BUTTON)) {
-			Coordination::shootBall(speed);
+		bool auto_aim_button = inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::AUTO_AIM_BUTTON);
+		bool shoot_button = inputs->getButton(OIPorts::BUTTONS_JOYSTICK1, OIPorts::SHOOT_BUTTON);
+		if (auto_aim_button) {
+			if (shoot_button) {
+				Coordination::autoShoot();
+			}
+			else if (Coordination::getState() != Coordination::State::AUTO_SHOOT) { // let a shot finish
+				Coordination::autoAim();
+			}
+		}
+		else {
+			if (inputs->wasReleased(OIPorts::BUTTONS_JOYSTICK1, OIPorts::AUTO_AIM_BUTTON)) {
+				Coordination::interrupt();
+			}
+			if (shoot_button) {
+				Coordination::shootBall(speed);
+			}
 		}
 	}
 	
 	void climberProcess()
 	{
 		////// Winches & Climber Arm //////
-		bool winch_switch = buttons_joy2->GetRawButton(OIPorts::MANUAL_WINCH_ENABLE_SWITCH);
+		bool winch_switch = inputs->getButton(OIPorts::BUTTONS_JOYSTICK2, OIPorts::MANUAL_WINCH_ENABLE_SWITCH);
 		if (winch_switch) {
-			Winches::setFrontSpeed(getJoystickAnalogPort(buttons_joy2, OIPorts::FRONT_WINCH_JOYSTICK, JOYSTICK_DEADZONE));
-			Winches::setFrontSpeed(getJoystickAnalogPort(buttons_joy2, OIPorts::BACK_WINCH_JOYSTICK, JOYSTICK_DEADZONE));
+			Winches::setFrontSpeed(getJoystickAnalogPort(OIPorts::BUTTONS_JOYSTICK2, OIPorts::FRONT_WINCH_JOYSTICK, JOYSTICK_DEADZONE));
+			Winches::setFrontSpeed(getJoystickAnalogPort(OIPorts::BUTTONS_JOYSTICK2, OIPorts::BACK_WINCH_JOYSTICK, JOYSTICK_DEADZONE));
 		}
 		else {
-			ClimberArm::setSpeed(getJoystickAnalogPort(buttons_joy2, OIPorts::FRONT_WINCH_JOYSTICK));
+			ClimberArm::setSpeed(getJoystickAnalogPort(OIPorts::BUTTONS_JOYSTICK2, OIPorts::FRONT_WINCH_JOYSTICK));
 		}
 	}
 	
@@ -1,12 +1,33 @@
 #ifndef SRC_OI_H_
 #define SRC_OI_H_
 
+namespace ED
+{
+	class InputSnapshot;
+}
+
 namespace OI
 {
 	void initialize();
 	void process();
 	
+	/**
+	 * Copies the joysticks for this loop, which process does before anything
+	 * else, so that the whole loop reads the same inputs
+	 */
+	void captureInputs();
+	
+	/**
+	 * Returns the joysticks as of the last capture
+	 */
+	const ED::InputSnapshot& getInputs();
+	
 	bool isPIDEnabled();
+	
+	/**
+	 * Returns whether the profile report button was just pressed
+	 */
+	bool isProfileReportRequested();
 }
 
 #endif /* SRC_OI_H_ */
@@ -0,0 +1,303 @@
+#include <ED/PoseEKF.hpp>
+#include <Subsystems/Cameras.hpp>
+#include <Subsystems/Mobility.hpp>
+#include <Subsystems/Odometry.hpp>
+#include <Subsystems/Sensors.hpp>
+#include <WPILib.h>
+
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+namespace Odometry
+{
+	const int HISTORY_LENGTH = 256;
+	const double HISTORY_PERIOD = 0.005; // seconds between recorded poses
+
+	/*
+	 * When the EKF is enabled, the pose is corrected every EKF_PERIOD with the
+	 * filter's estimate, which also uses the navX accelerometer, the LIDAR and
+	 * the camera.  Between corrections the pose is dead reckoned as usual.
+	 */
+	const bool EKF_ENABLED = true;
+	const double EKF_PERIOD = 0.01; // seconds
+
+	const float FIELD_LENGTH = 1646.0;
+	const float FIELD_WIDTH = 810.0;
+	const float GOAL_X = FIELD_LENGTH; // the center goal of the opponents' tower
+	const float GOAL_Y = FIELD_WIDTH / 2.0;
+	const float LIDAR_FORWARD_OFFSET = 40.0; // distance from the center of the robot to the front, TODO: measure
+
+	ED::PoseEKF::Config getEKFConfig()
+	{
+		ED::PoseEKF::Config config;
+		config.position_noise = 1.0;
+		config.heading_noise = 1.0;
+		config.speed_noise = 2500.0;
+		config.turn_rate_noise = 2500.0;
+		config.acceleration_noise = 250000.0;
+
+		config.speed_measurement_noise = 5.0;
+		config.turn_rate_measurement_noise = 2.0;
+		config.acceleration_measurement_noise = 100.0;
+		config.lidar_measurement_noise = 5.0;
+		config.bearing_measurement_noise = 1.5;
+		config.goal_range_measurement_noise = 50.0;
+		config.outlier_gate = 3.0;
+
+		config.lidar_forward_offset = LIDAR_FORWARD_OFFSET;
+		config.goal_x = GOAL_X;
+		config.goal_y = GOAL_Y;
+
+		// the four outside walls of the field; the defenses are too low for the LIDAR
+		ED::PoseEKF::Wall walls[] = {
+			{ 1.0, 0.0, 0.0 },
+			{ 1.0, 0.0, FIELD_LENGTH },
+			{ 0.0, 1.0, 0.0 },
+			{ 0.0, 1.0, FIELD_WIDTH }
+		};
+		config.wall_count = sizeof(walls) / sizeof(*walls);
+		for (int i = 0; i < config.wall_count; ++i) {
+			config.walls[i] = walls[i];
+		}
+		return config;
+	}
+
+	ED::PoseEKF ekf(getEKFConfig());
+	float ekf_last_distance = 0.0;
+	double last_lidar_timestamp = 0.0;
+	double last_target_timestamp = 0.0;
+
+	Pose pose = { 0.0, 0.0, 0.0, 0.0 };
+
+	// the history is a ring buffer, history_end is where the next pose will go
+	Pose history[HISTORY_LENGTH];
+	int history_end = 0;
+	int history_count = 0;
+
+	float last_left_dist = 0.0;
+	float last_right_dist = 0.0;
+	float last_robot_angle = 0.0;
+	bool last_gyro_enabled = false;
+
+	float distance_traveled = 0.0;
+	float speed = 0.0;
+
+	float getPhysicalLeftDistance();
+	float getPhysicalRightDistance();
+	void record(const Pose& new_pose);
+	Pose interpolate(const Pose& a, const Pose& b, double timestamp);
+	void processEKF(double timestamp);
+
+	void initialize()
+	{
+		reset(0.0, 0.0, 0.0);
+	}
+
+	void process()
+	{
+		double timestamp = Timer::GetFPGATimestamp();
+
+		float left_dist = getPhysicalLeftDistance();
+		float right_dist = getPhysicalRightDistance();
+		float delta_left = left_dist - last_left_dist;
+		float delta_right = right_dist - last_right_dist;
+		float delta_dist = (delta_left + delta_right) / 2.0;
+
+		float delta_heading;
+		bool gyro_enabled = Sensors::isGyroEnabled();
+		float robot_angle = Sensors::getContinuousRobotAngle();
+		if (gyro_enabled && last_gyro_enabled) {
+			delta_heading = robot_angle - last_robot_angle;
+		}
+		else {
+			// fall back to the difference between the drive sides; turning right
+			// (clockwise) means the left side has gone further
+			delta_heading = (delta_left - delta_right) / Mobility::getDriveGains().wheelbase * 180.0 / M_PI;
+		}
+
+		// integrate along the average heading over the step, which is exact for arcs
+		// to first order and much better than using either endpoint
+		float mid_heading = (pose.heading + delta_heading / 2.0) * M_PI / 180.0;
+		pose.x += delta_dist * cos(mid_heading);
+		pose.y += delta_dist * sin(mid_heading);
+		pose.heading += delta_heading;
+
+		double dt = timestamp - pose.timestamp;
+		if (dt > 0.0) {
+			speed = delta_dist / dt;
+		}
+		pose.timestamp = timestamp;
+
+		distance_traveled += delta_dist;
+		last_left_dist = left_dist;
+		last_right_dist = right_dist;
+		last_robot_angle = robot_angle;
+		last_gyro_enabled = gyro_enabled;
+
+		if (EKF_ENABLED && timestamp - ekf.getTimestamp() >= EKF_PERIOD) {
+			processEKF(timestamp);
+		}
+
+		if (history_count == 0 || timestamp - history[(history_end + HISTORY_LENGTH - 1) % HISTORY_LENGTH].timestamp >= HISTORY_PERIOD) {
+			record(pose);
+		}
+	}
+
+	void reset(float x, float y, float heading)
+	{
+		pose.timestamp = Timer::GetFPGATimestamp();
+		pose.x = x;
+		pose.y = y;
+		pose.heading = heading;
+
+		last_left_dist = getPhysicalLeftDistance();
+		last_right_dist = getPhysicalRightDistance();
+		last_robot_angle = Sensors::getContinuousRobotAngle();
+		last_gyro_enabled = Sensors::isGyroEnabled();
+		speed = 0.0;
+
+		history_end = 0;
+		history_count = 0;
+		record(pose);
+
+		ekf.reset(pose.timestamp, x, y, heading);
+		ekf_last_distance = distance_traveled;
+		last_lidar_timestamp = Sensors::getLidarTimestamp();
+		last_target_timestamp = Cameras::getTargetTimestamp();
+	}
+
+	Pose getPose()
+	{
+		return pose;
+	}
+
+	Pose getPoseAt(double timestamp)
+	{
+		int oldest = (history_end + HISTORY_LENGTH - history_count) % HISTORY_LENGTH;
+		if (timestamp >= pose.timestamp) {
+			return pose;
+		}
+		if (timestamp <= history[oldest].timestamp) {
+			return history[oldest];
+		}
+
+		// binary search over the ring buffer for the last pose at or before timestamp,
+		// indices are counted from the oldest entry
+		int low = 0;
+		int high = history_count - 1;
+		while (low < high) {
+			int mid = (low + high + 1) / 2;
+			if (history[(oldest + mid) % HISTORY_LENGTH].timestamp <= timestamp) {
+				low = mid;
+			}
+			else {
+				high = mid - 1;
+			}
+		}
+
+		const Pose& before = history[(oldest + low) % HISTORY_LENGTH];
+		if (low == history_count - 1) {
+			// between the last recorded pose and the current one
+			return interpolate(before, pose, timestamp);
+		}
+		return interpolate(before, history[(oldest + low + 1) % HISTORY_LENGTH], timestamp);
+	}
+
+	float getX()
+	{
+		return pose.x;
+	}
+
+	float getY()
+	{
+		return pose.y;
+	}
+
+	float getHeading()
+	{
+		return pose.heading;
+	}
+
+	float getDistanceTraveled()
+	{
+		return distance_traveled;
+	}
+
+	float getSpeed()
+	{
+		return speed;
+	}
+
+	float getPhysicalLeftDistance()
+	{
+		// Sensors reports distances relative to the driver's idea of forward
+		return Mobility::usingNormalOrientation() ? Sensors::getLeftEncoderDistance() : -Sensors::getLeftEncoderDistance();
+	}
+
+	float getPhysicalRightDistance()
+	{
+		return Mobility::usingNormalOrientation() ? Sensors::getRightEncoderDistance() : -Sensors::getRightEncoderDistance();
+	}
+
+	void record(const Pose& new_pose)
+	{
+		history[history_end] = new_pose;
+		history_end = (history_end + 1) % HISTORY_LENGTH;
+		if (history_count < HISTORY_LENGTH) {
+			++history_count;
+		}
+	}
+
+	void processEKF(double timestamp)
+	{
+		double dt = timestamp - ekf.getTimestamp();
+		ekf.predict(timestamp);
+
+		if (Sensors::areDriveEncodersEnabled()) {
+			ekf.correctSpeed((distance_traveled - ekf_last_distance) / dt);
+		}
+		ekf_last_distance = distance_traveled;
+
+		if (Sensors::isGyroEnabled()) {
+			ekf.correctTurnRate(Sensors::getRobotTurnRate());
+			ekf.correctAcceleration(Sensors::getForwardAcceleration());
+		}
+
+		// the LIDAR and camera are slower than the loop, so only use new readings,
+		// and tell the filter when they were taken so it can account for the delay
+		double lidar_timestamp = Sensors::getLidarTimestamp();
+		if (Sensors::isLidarEnabled() && lidar_timestamp != last_lidar_timestamp) {
+			ekf.correctLidarRange(lidar_timestamp, Sensors::getLidarDistance());
+		}
+		last_lidar_timestamp = lidar_timestamp;
+
+		double target_timestamp = Cameras::getTargetTimestamp();
+		if (Cameras::canSeeGoal() && target_timestamp != last_target_timestamp) {
+			ekf.correctGoalBearing(target_timestamp, Cameras::getTargetBearing());
+			ekf.correctGoalRange(target_timestamp, Cameras::getDistanceFromTarget());
+		}
+		last_target_timestamp = target_timestamp;
+
+		pose.x = ekf.getX();
+		pose.y = ekf.getY();
+		pose.heading = ekf.getHeading();
+		speed = ekf.getSpeed();
+	}
+
+	Pose interpolate(const Pose& a, const Pose& b, double timestamp)
+	{
+		double span = b.timestamp - a.timestamp;
+		if (span <= 0.0) {
+			return a;
+		}
+		float ratio = (timestamp - a.timestamp) / span;
+
+		Pose result;
+		result.timestamp = timestamp;
+		result.x = a.x + (b.x - a.x) * ratio;
+		result.y = a.y + (b.y - a.y) * ratio;
+		result.heading = a.heading + (b.heading - a.heading) * ratio;
+		return result;
+	}
+}
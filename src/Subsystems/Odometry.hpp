@@ -0,0 +1,69 @@
+#ifndef SRC_SUBSYSTEMS_ODOMETRY_H_
+#define SRC_SUBSYSTEMS_ODOMETRY_H_
+
+namespace Odometry
+{
+	/*
+	 * Positions are in centimeters on the field, from the corner to the left of
+	 * our driver stations.  x points downfield toward the goal we shoot at and y
+	 * points to the right, so that headings match the navX: degrees, clockwise
+	 * positive from downfield, and continuous (a full turn to the right is 360,
+	 * not 0).  The position is only meaningful on the field if reset() was given
+	 * the starting position, which Autonomous does.
+	 */
+	struct Pose {
+		double timestamp; // seconds, FPGA clock
+		float x;
+		float y;
+		float heading;
+	};
+
+	/*
+	 * The center of the goal we shoot at
+	 */
+	extern const float GOAL_X;
+	extern const float GOAL_Y;
+
+	void initialize();
+	void process();
+
+	/**
+	 * Sets the current position of the robot, and clears the pose history
+	 */
+	void reset(float x, float y, float heading);
+
+	/**
+	 * Returns the most recent pose estimate
+	 */
+	Pose getPose();
+
+	/**
+	 * Looks up where the robot was at some time in the recent past, interpolating
+	 * between the recorded poses.  Useful for matching measurements that arrive
+	 * late, like camera frames, to where the robot was when they were taken.
+	 *
+	 * Times older than the history are clamped to the oldest recorded pose, and
+	 * times in the future are clamped to the most recent pose.
+	 * @param  timestamp seconds, FPGA clock
+	 */
+	Pose getPoseAt(double timestamp);
+
+	float getX();
+	float getY();
+	float getHeading();
+
+	/**
+	 * Returns the signed distance driven along the path of the robot since
+	 * bootup in centimeters, which is the average of the two sides of the drive
+	 * train.  Unlike the encoder distances in Sensors, this doesn't change sign
+	 * when Mobility changes orientation.
+	 */
+	float getDistanceTraveled();
+
+	/**
+	 * Returns the forward speed of the robot in centimeters per second
+	 */
+	float getSpeed();
+}
+
+#endif /* SRC_SUBSYSTEMS_ODOMETRY_H_ */
@@ -0,0 +1,114 @@
+#include <Ports/PDP.hpp>
+#include <Subsystems/PowerBudget.hpp>
+#include <Subsystems/Sensors.hpp>
+#include <Utils.hpp>
+#include <WPILib.h>
+
+namespace PowerBudget
+{
+	struct Budget {
+		float sag_start_voltage; // volts below which the consumer starts being scaled down
+		float sag_end_voltage; // volts at which it's at its minimum scale
+		float min_scale;
+		float max_current; // amperes across all its channels
+	};
+
+	// in the same order as Consumer; the roboRIO browns out at 6.8 volts
+	const Budget BUDGETS[] = {
+		{ 9.0, 7.2, 0.3, 200.0 },
+		{ 7.5, 6.9, 0.6, 60.0 },
+		{ 9.5, 7.5, 0.2, 80.0 }
+	};
+	static_assert(sizeof(BUDGETS) / sizeof(*BUDGETS) == CONSUMER_COUNT, "every consumer needs a budget");
+
+	const float RECOVERY_RATE = 0.5; // scale per second
+
+	float scales[CONSUMER_COUNT];
+	Timer* budget_timer;
+
+	float getCurrent(Consumer consumer);
+
+	void initialize()
+	{
+		for (int i = 0; i < CONSUMER_COUNT; ++i) {
+			scales[i] = 1.0;
+		}
+
+		budget_timer = Utils::constructTimer();
+		budget_timer->Start();
+	}
+
+	void process()
+	{
+		float period = budget_timer->Get();
+		budget_timer->Reset();
+
+		// without the PDP there's nothing to budget by
+		float voltage = Sensors::getBatteryVoltage();
+		if (!Sensors::isPDPEnabled() || voltage <= 0.0) {
+			for (int i = 0; i < CONSUMER_COUNT; ++i) {
+				scales[i] = 1.0;
+			}
+			return;
+		}
+
+		for (int i = 0; i < CONSUMER_COUNT; ++i) {
+			const Budget& budget = BUDGETS[i];
+
+			float target = 1.0;
+			if (voltage < budget.sag_start_voltage) {
+				float sag = (budget.sag_start_voltage - voltage) / (budget.sag_start_voltage - budget.sag_end_voltage);
+				target = 1.0 - sag * (1.0 - budget.min_scale);
+			}
+
+			float current = getCurrent((Consumer)i);
+			if (current > budget.max_current) {
+				// the current is measured at the present scale
+				float current_target = scales[i] * budget.max_current / current;
+				if (current_target < target) {
+					target = current_target;
+				}
+			}
+
+			if (target < budget.min_scale) {
+				target = budget.min_scale;
+			}
+
+			if (target < scales[i]) {
+				scales[i] = target;
+			}
+			else {
+				scales[i] += RECOVERY_RATE * period;
+				if (scales[i] > target) {
+					scales[i] = target;
+				}
+			}
+		}
+	}
+
+	float getScale(Consumer consumer)
+	{
+		if (consumer < 0 || consumer >= CONSUMER_COUNT) {
+			return 1.0;
+		}
+		return scales[consumer];
+	}
+
+	float getCurrent(Consumer consumer)
+	{
+		switch (consumer) {
+		case Consumer::MOBILITY:
+			return Sensors::getCurrent(PDPPorts::RIGHT_MOTOR1) + Sensors::getCurrent(PDPPorts::RIGHT_MOTOR2) +
+				Sensors::getCurrent(PDPPorts::LEFT_MOTOR1) + Sensors::getCurrent(PDPPorts::LEFT_MOTOR2);
+
+		case Consumer::SHOOTER_WHEELS:
+			return Sensors::getCurrent(PDPPorts::SHOOTER_WHEELS_MOTOR);
+
+		case Consumer::WINCHES:
+			return Sensors::getCurrent(PDPPorts::FRONT_WINCH_MOTOR) + Sensors::getCurrent(PDPPorts::BACK_WINCH_MOTOR);
+
+		default:
+			return 0.0;
+		}
+	}
+}
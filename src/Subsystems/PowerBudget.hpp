@@ -0,0 +1,36 @@
+#ifndef SRC_SUBSYSTEMS_POWERBUDGET_H_
+#define SRC_SUBSYSTEMS_POWERBUDGET_H_
+
+/**
+ * Keeps the battery out of brownout by turning down the mechanisms that draw
+ * the most current, in order of how little they matter to scoring.
+ *
+ * As the battery voltage sags, each consumer's outputs are scaled down,
+ * starting at a higher voltage for the drive and winches than for the
+ * shooter wheels, so that pushing matches slow the drive before the flywheel
+ * loses speed.  Each consumer also has a current budget across its PDP
+ * channels, and is scaled down while it draws more than that.
+ *
+ * Scales drop straight away and recover gradually, so that the current
+ * dropping after a cut doesn't immediately undo it.
+ */
+namespace PowerBudget
+{
+	enum Consumer {
+		MOBILITY,
+		SHOOTER_WHEELS,
+		WINCHES,
+		CONSUMER_COUNT
+	};
+
+	void initialize();
+	void process();
+
+	/**
+	 * Returns what the consumer's outputs should be multiplied by, from 1.0
+	 * when there's power to spare down to the consumer's minimum
+	 */
+	float getScale(Consumer consumer);
+}
+
+#endif /* SRC_SUBSYSTEMS_POWERBUDGET_H_ */
@@ -1,9 +1,12 @@
+#include <ED/PowerMonitor.hpp>
+#include <ED/Tachometer.hpp>
 #include <ED/Utils.hpp>
 #include <NAVX/AHRS.h>
 #include <Ports/Analog.hpp>
 #include <Ports/CAN.hpp>
 #include <Ports/Digital.hpp>
 #include <Ports/I2C.hpp>
+#include <Profiler.hpp>
 #include <Subsystems/Mobility.hpp>
 #include <Subsystems/Sensors.hpp>
 #include <Utils.hpp>
@@ -26,9 +29,19 @@ namespace Sensors
 	const float MAX_INTAKE_ENCODER_VOLT = 3.72;
 
 	const int SHOOTER_WHEEL_PPR = 1;
+	const int SHOOTER_WHEEL_TACH_FILTER_LENGTH = 5; // periods in the median
+	const float SHOOTER_WHEEL_TACH_SMOOTHING = 0.5;
+	const double SHOOTER_WHEEL_STALL_TIME = 0.25; // seconds without a pulse before the wheels are stopped, about 240 rpm
+	const double SHOOTER_WHEEL_TACH_POLL_PERIOD = 0.002;
 
 	const int LIDAR_OFFSET = 10;
 
+	const double PDP_SAMPLE_PERIOD = 0.02; // seconds between readings of every PDP channel
+
+	// the autonomous selectors are rotary switches wired as voltage dividers
+	const int AUTONOMOUS_SWITCH_POSITIONS = 10;
+	const float AUTONOMOUS_SWITCH_MAX_VOLT = 5.0;
+
 	const float DRIVE_WHEEL_DIAMETER = 7.9502;
 	const int DRIVE_ENCODER_PPR = 128;
 	
@@ -62,16 +75,17 @@ namespace Sensors
 
 	AnalogInput* intake_encoder;
 
-	Timer* tach_timer;
-	Counter* shooter_wheel_tach;
-	float last_tach_timestamp = 0.0;
-	int last_tach_count = 0;
-	float tach_rate = 0.0;
+	AnalogInput* autonomous_position_switch;
+	AnalogInput* autonomous_defense_switch;
+	AnalogInput* autonomous_shoot_switch;
+
+	ED::Tachometer* shooter_wheel_tach;
 
 	Timer* lidar_timer;
 	I2C* lidar;
 	int lidar_distance = 0; // centimeters
 	int lidar_stage = 0;
+	double lidar_timestamp = 0.0;
 
 	Encoder* left_drive_encoder;
 	Encoder* right_drive_encoder;
@@ -79,7 +93,7 @@ namespace Sensors
 	DigitalInput* ball_limit;
 	DigitalInput* shooter_limit;
 
-	PowerDistributionPanel* pdp;
+	ED::PowerMonitor* power_monitor;
 
 	void initialize()
 	{
@@ -89,10 +103,14 @@ namespace Sensors
 
 		intake_encoder = new AnalogInput(AnalogPorts::INTAKE_ENCODER);
 
-		tach_timer = new Timer();
-		shooter_wheel_tach = new Counter(DigitalPorts::SHOOTER_WHEEL_TACH);
+		autonomous_position_switch = new AnalogInput(AnalogPorts::AUTONOMOUS_POSITION_SWITCH);
+		autonomous_defense_switch = new AnalogInput(AnalogPorts::AUTONOMOUS_DEFENSE_SWITCH);
+		autonomous_shoot_switch = new AnalogInput(AnalogPorts::AUTONOMOUS_SHOOT_SWITCH);
 
-		lidar_timer = new Timer();
+		shooter_wheel_tach = new ED::Tachometer(DigitalPorts::SHOOTER_WHEEL_TACH, SHOOTER_WHEEL_PPR, SHOOTER_WHEEL_TACH_FILTER_LENGTH,
+			SHOOTER_WHEEL_TACH_SMOOTHING, SHOOTER_WHEEL_STALL_TIME, SHOOTER_WHEEL_TACH_POLL_PERIOD);
+
+		lidar_timer = Utils::constructTimer();
 		lidar = new I2C(I2C::Port::kMXP, I2CPorts::LIDAR_ADDRESS);
 
 		left_drive_encoder = new Encoder(DigitalPorts::LEFT_ENCODER_A, DigitalPorts::LEFT_ENCODER_B);
@@ -101,16 +119,14 @@ namespace Sensors
 		ball_limit = new DigitalInput(DigitalPorts::BALL_LIMIT);
 		shooter_limit = new DigitalInput(DigitalPorts::SHOOTER_LIMIT);
 
-		pdp = new PowerDistributionPanel(CANPorts::PDP);
+		power_monitor = new ED::PowerMonitor(CANPorts::PDP, PDP_SAMPLE_PERIOD);
 
 		float distance_per_pulse = 2.0 * M_PI * DRIVE_WHEEL_DIAMETER / (float)DRIVE_ENCODER_PPR;
 		left_drive_encoder->SetDistancePerPulse(distance_per_pulse);
 		right_drive_encoder->SetDistancePerPulse(distance_per_pulse);
 
-		tach_timer->Start();
 		lidar_timer->Start();
 
-		tach_timer->Reset();
 		lidar_timer->Reset();
 	}
 
@@ -118,6 +134,7 @@ namespace Sensors
 	{
 		// update lidar
 		if (lidar_timer->Get() > (0.04 * (float)lidar_stage)) {
+			Profiler::Scope lidar_scope(Profiler::LIDAR_TRANSACTION);
 			uint8_t lidar_range_copy;
 			switch (lidar_stage) {
 			case 0:
@@ -133,6 +150,7 @@ namespace Sensors
 				uint8_t buffer[2];
 				lidar->ReadOnly(2, buffer);
 				lidar_distance = ((buffer[0] << 8) + buffer[1]) - LIDAR_OFFSET;
+				lidar_timestamp = Timer::GetFPGATimestamp();
 				++lidar_stage;
 				break;
 			case 3:
@@ -141,19 +159,6 @@ namespace Sensors
 			}
 		}
 
-		// update shooter wheel tachometer speed
-		int tach_count = shooter_wheel_tach->Get();
-		float tach_timestamp = tach_timer->Get();
-		if (tach_count > last_tach_count) {
-			tach_rate = (tach_count - last_tach_count) / (tach_timestamp - last_tach_timestamp) / (float)SHOOTER_WHEEL_PPR * 60.0;
-
-			last_tach_count = tach_count;
-			last_tach_timestamp = tach_timestamp;
-		}
-		else if (tach_timestamp - last_tach_timestamp > 1.0) {
-			tach_rate = 0.0;
-		}
-
 		// update the shooter home switch
 		if (isShooterLimitPressed() && isShooterAngleEnabled()) {
 			shooter_angle_offset = getShooterAngleActual();
@@ -170,6 +175,49 @@ namespace Sensors
 		}
 	}
 
+	float getContinuousRobotAngle()
+	{
+		if (isGyroEnabled()) {
+			return navx->GetAngle();
+		}
+		else {
+			return 0.0;
+		}
+	}
+
+	float getRobotTurnRate()
+	{
+		if (isGyroEnabled()) {
+			return navx->GetRate();
+		}
+		else {
+			return 0.0;
+		}
+	}
+
+	double getGyroTimestamp()
+	{
+		if (isGyroEnabled()) {
+			return navx->GetLastReceivedTimestamp();
+		}
+		else {
+			return 0.0;
+		}
+	}
+
+	float getForwardAcceleration()
+	{
+		if (isGyroEnabled()) {
+			// the navX reports gravity-free acceleration in Gs along the axes it had when
+			// its yaw was zeroed, so rotate it back into the frame of the robot
+			float yaw = navx->GetYaw() * M_PI / 180.0;
+			return 980.665 * (navx->GetWorldLinearAccelX() * cos(yaw) + navx->GetWorldLinearAccelY() * sin(yaw));
+		}
+		else {
+			return 0.0;
+		}
+	}
+
 	float getShooterAngleActual()
 	{
 		return 90.0 * (shooter_encoder->GetVoltage() - MIN_SHOOTER_ENCODER_VOLT) / (MAX_SHOOTER_ENCODER_VOLT - MIN_SHOOTER_ENCODER_VOLT);
@@ -201,7 +249,31 @@ namespace Sensors
 	float getShooterWheelRate()
 	{
 		if (isShooterTachEnabled()) {
-			return tach_rate;
+			return shooter_wheel_tach->getRPM();
+		}
+		else {
+			return 0.0;
+		}
+	}
+
+	double getShooterWheelRateAge()
+	{
+		if (isShooterTachEnabled()) {
+			return shooter_wheel_tach->getAge();
+		}
+		else {
+			return 0.0;
+		}
+	}
+
+	double getShooterWheelTimestamp()
+	{
+		if (isShooterTachEnabled()) {
+			float rpm;
+			double timestamp;
+			bool stalled;
+			shooter_wheel_tach->getState(rpm, timestamp, stalled);
+			return timestamp;
 		}
 		else {
 			return 0.0;
@@ -218,6 +290,11 @@ namespace Sensors
 		}
 	}
 
+	double getLidarTimestamp()
+	{
+		return lidar_timestamp;
+	}
+
 	float getLeftEncoderDistance()
 	{
 		if (areDriveEncodersEnabled()) {
@@ -300,10 +377,45 @@ namespace Sensors
 		}
 	}
 
+	int getAutonomousPosition()
+	{
+		return ED::convertVoltage(autonomous_position_switch->GetVoltage(), AUTONOMOUS_SWITCH_POSITIONS, AUTONOMOUS_SWITCH_MAX_VOLT);
+	}
+
+	int getAutonomousDefense()
+	{
+		return ED::convertVoltage(autonomous_defense_switch->GetVoltage(), AUTONOMOUS_SWITCH_POSITIONS, AUTONOMOUS_SWITCH_MAX_VOLT);
+	}
+
+	int getAutonomousShoot()
+	{
+		return ED::convertVoltage(autonomous_shoot_switch->GetVoltage(), AUTONOMOUS_SWITCH_POSITIONS, AUTONOMOUS_SWITCH_MAX_VOLT);
+	}
+
 	float getCurrent(unsigned int channel)
 	{
 		if (isPDPEnabled()) {
-			return pdp->GetCurrent(channel);
+			return power_monitor->getCurrent(channel);
+		}
+		else {
+			return 0.0;
+		}
+	}
+
+	float getTotalCurrent()
+	{
+		if (isPDPEnabled()) {
+			return power_monitor->getTotalCurrent();
+		}
+		else {
+			return 0.0;
+		}
+	}
+
+	float getBatteryVoltage()
+	{
+		if (isPDPEnabled()) {
+			return power_monitor->getVoltage();
 		}
 		else {
 			return 0.0;
@@ -17,6 +17,29 @@ namespace Sensors
 	 */
 	float getRobotAngle();
 
+	/**
+	 * Returns the angle (yaw) of the robot from it's position at bootup without
+	 * wrapping at +/-180, so a full turn to the right reads 360 degrees
+	 */
+	float getContinuousRobotAngle();
+
+	/**
+	 * Returns the turn rate (yaw rate) of the robot in degrees per second
+	 */
+	float getRobotTurnRate();
+
+	/**
+	 * Returns the FPGA time in seconds at which the current angle and turn rate
+	 * were received from the navX, or 0.0 before the first
+	 */
+	double getGyroTimestamp();
+
+	/**
+	 * Returns the acceleration of the robot along its forward direction in
+	 * centimeters per second squared, with gravity removed
+	 */
+	float getForwardAcceleration();
+
 	/**
 	 * Returns the angle (pitch) of the shooter from it's home position in degrees
 	 */
@@ -32,12 +55,29 @@ namespace Sensors
 	 */
 	float getShooterWheelRate();
 
+	/**
+	 * Returns how many seconds old the shooter wheel rate is, measured from the
+	 * tachometer pulse it was last updated by
+	 */
+	double getShooterWheelRateAge();
+
+	/**
+	 * Returns the FPGA time in seconds of the tachometer pulse the shooter wheel
+	 * rate was last updated by, or of the last check once the wheels have stopped
+	 */
+	double getShooterWheelTimestamp();
+
 	/**
 	 * Returns the distance between the front of the robot and the object closest
 	 * in front of it, as measured by the LIDAR sensor in centimeters
 	 */
 	int getLidarDistance();
 
+	/**
+	 * Returns the FPGA time in seconds at which the current LIDAR distance was read
+	 */
+	double getLidarTimestamp();
+
 	/**
 	 * Returns the distance traveled by the left drive wheels since bootup in centimeters
 	 */
@@ -70,10 +110,30 @@ namespace Sensors
 	bool isShooterLimitPressed();
 
 	/**
-	 * Returns the current draw on a Power Distribution Panel channel in amperes
+	 * Return the positions of the three rotary switches on the robot that choose
+	 * the autonomous play, as passed to Autonomous::initialize
+	 */
+	int getAutonomousPosition();
+	int getAutonomousDefense();
+	int getAutonomousShoot();
+
+	/**
+	 * Returns the current draw on a Power Distribution Panel channel in amperes.
+	 * The PDP is read in the background, so this doesn't wait on CAN.
 	 */
 	float getCurrent(unsigned int channel);
 
+	/**
+	 * Returns the current draw of the whole robot in amperes
+	 */
+	float getTotalCurrent();
+
+	/**
+	 * Returns the battery voltage measured by the PDP, or 0.0 before the first
+	 * reading
+	 */
+	float getBatteryVoltage();
+
 	/**
 	 * The below functions check to see if the corresponding sensors are allowed to be
 	 * used.  Function calls to Sensors that rely on disabled sensors will return some
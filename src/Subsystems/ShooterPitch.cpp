@@ -1,4 +1,8 @@
+#include <CANTalon.h>
+#include <ED/ClosedLoopActuator.hpp>
+#include <ED/MotionProfile.hpp>
 #include <ED/PIDManager.hpp>
+#include <Outputs.hpp>
 #include <Ports/Motor.hpp>
 #include <Subsystems/OI.hpp>
 #include <Subsystems/Sensors.hpp>
@@ -6,12 +10,40 @@
 #include <Utils.hpp>
 #include <WPILib.h>
 
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+const float GRAVITY_FEED_FORWARD = 0.08; // output that holds the shooter level, TODO: measure
+const float VELOCITY_FEED_FORWARD = 1.0 / 120.0; // output per degree per second, TODO: measure
+const float DERIVATIVE_FILTER_TIME = 0.02; // seconds, so pot noise doesn't reach the motor, TODO: tune
+const float BACK_CALCULATION_TIME = 0.2; // seconds to unwind the integral term while the motor is saturated, TODO: tune
+
 class ShooterPitchPID : public ED::PIDManager
 {
 public:
-	ShooterPitchPID() : PIDManager(0.1, 0.0001, 0.0)
+	ShooterPitchPID() : PIDManager(0.1, 0.0001, 0.0, GRAVITY_FEED_FORWARD)
 	{
 		autoClearAccumulatedError(true);
+		setDerivativeFilter(DERIVATIVE_FILTER_TIME);
+		setBackCalculation(-1.0, 1.0, BACK_CALCULATION_TIME);
+		
+		// near the bottom the shooter rests on its limit switch, where an
+		// integral term only winds up against it and nothing needs holding up,
+		// TODO: tune
+		addGainSlot(0.0, { 0.06, 0.0, 0.0, 0.0 });
+		addGainSlot(15.0, { 0.1, 0.0001, 0.0, GRAVITY_FEED_FORWARD });
+		addGainSlot(75.0, { 0.12, 0.0001, 0.0, GRAVITY_FEED_FORWARD });
+	}
+
+	/**
+	 * Sets the target to a point along a motion profile, so that the
+	 * feed-forward can include how fast the shooter should be moving
+	 */
+	void setProfiledTarget(float angle, float velocity)
+	{
+		profile_velocity = velocity;
+		setTarget(angle);
 	}
 
 protected:
@@ -20,10 +52,19 @@ protected:
 		return Sensors::getShooterAngle();
 	}
 
+	float getFeedForwardOutput(float new_target)
+	{
+		// gravity pulls hardest on the shooter when it's level
+		return getF() * cos(new_target * M_PI / 180.0) + VELOCITY_FEED_FORWARD * profile_velocity;
+	}
+
 	void usePIDOutput(float output, float feed_forward)
 	{
-		ShooterPitch::setSpeed(output);
+		ShooterPitch::setSpeed(output + feed_forward);
 	}
+
+private:
+	float profile_velocity = 0.0;
 };
 
 namespace ShooterPitch
@@ -32,6 +73,22 @@ namespace ShooterPitch
 	const float MOTOR_SPEED = 1.0;
 	const float ACCEPTABLE_ERROR = 0.5;
 	
+	// limits for moving between angles with the PID
+	const float MAX_VELOCITY = 90.0; // degrees per second
+	const float MAX_ACCELERATION = 360.0; // degrees per second squared
+	const float MAX_JERK = 3600.0; // degrees per second cubed
+	
+	// used when the shooter has a CANTalon, which then runs the PID itself from
+	// the encoder wired to its analog input, 0 - 1023 across 0.0 - 3.3 volts,
+	// TODO: check against the home position once it's wired to the Talon
+	const ED::ClosedLoopActuator::Config TALON_CONFIG = {
+		ED::ClosedLoopActuator::Mode::POSITION,
+		CANTalon::AnalogEncoder,
+		false,
+		(2.6 - 1.4) / 90.0 * 1023.0 / 3.3, // per degree
+		1.4 * 1023.0 / 3.3
+	};
+	
 	const float ANGLE_PRESETS[] = {
 		0.0,
 		15.0,
@@ -45,21 +102,28 @@ namespace ShooterPitch
 	
 	ShooterPitchPID* pid_manager = nullptr;
 	SpeedController* pitch_motor = nullptr;
+	ED::ClosedLoopActuator* angle_actuator = nullptr;
+	
+	ED::MotionProfile* angle_profile;
+	double profile_start_time = 0.0;
+	float goal_angle = 0.0;
+	float hold_feed_forward = 0.0; // the gravity feed-forward scheduled for goal_angle, for holding without PID
 	
 	void setState(State new_state);
+	float stopAtHome(float speed);
 	
 	void initialize()
 	{
 		pid_manager = new ShooterPitchPID();
 		pitch_motor = Utils::constructMotor(MotorPorts::SHOOTER_PITCH_MOTOR);
+		angle_actuator = new ED::ClosedLoopActuator(pitch_motor, pid_manager, TALON_CONFIG);
+		Outputs::setInterlock(MotorPorts::SHOOTER_PITCH_MOTOR, stopAtHome);
+		
+		angle_profile = new ED::MotionProfile();
 	}
 
 	void process()
 	{
-		if (getDirection() == Utils::VerticalDirection::DOWN && Sensors::isShooterLimitPressed()) {
-			setSpeed(0.0);
-		}
-		
 		switch (state) {
 		case State::DISABLED:
 			setSpeed(0.0);
@@ -71,9 +135,10 @@ namespace ShooterPitch
 			break;
 		
 		case State::REACHING_ANGLE:
-			if (!pid_manager->isEnabled()) {
-				float error = pid_manager->getTarget() - Sensors::getShooterAngle();
-				if (fabs(error) < ACCEPTABLE_ERROR) {
+			if (!angle_actuator->isEnabled()) {
+				float angle = Sensors::getShooterAngle();
+				float error = goal_angle - angle;
+				if (fabs(error) > ACCEPTABLE_ERROR) {
 					if (error > 0) {
 						setDirection(Utils::VerticalDirection::UP);
 					}
@@ -82,7 +147,8 @@ namespace ShooterPitch
 					}
 				}
 				else {
-					setDirection(Utils::VerticalDirection::V_STILL);
+					// hold the shooter against gravity so it doesn't sag out of the zone
+					setSpeed(hold_feed_forward * cos(angle * M_PI / 180.0));
 				}
 			}
 		}
@@ -90,19 +156,25 @@ namespace ShooterPitch
 
 	void processPID()
 	{
-		pid_manager->process();
+		if (state == State::REACHING_ANGLE && angle_actuator->isEnabled()) {
+			ED::MotionProfile::State setpoint = angle_profile->sample(Timer::GetFPGATimestamp() - profile_start_time);
+			pid_manager->setProfiledTarget(setpoint.position, setpoint.velocity);
+		}
+		angle_actuator->process();
+	}
+
+	ED::PIDManager* getPIDManager()
+	{
+		return pid_manager;
 	}
 
 	void enablePID(bool enable)
 	{
-		pid_manager->enable(enable);
+		angle_actuator->enable(enable);
 	}
 
 	void setSpeed(float speed)
 	{
-		if (speed < 0.0 && Sensors::isShooterLimitPressed()) {
-			speed = 0.0;
-		}
 		if (state != State::DISABLED) {
 			pitch_motor->Set(speed);
 		}
@@ -148,11 +220,29 @@ namespace ShooterPitch
 	
 	void goToAngle(float degrees)
 	{
-		pid_manager->setTarget(degrees);
+		// start from the setpoint of a move that's still under way, so that the
+		// target doesn't jump back to where the shooter has lagged to
+		float start = Sensors::getShooterAngle();
+		if (state == State::REACHING_ANGLE && angle_actuator->isEnabled()) {
+			start = pid_manager->getTarget();
+		}
+		
+		goal_angle = degrees;
+		hold_feed_forward = pid_manager->getScheduledGains(degrees).f;
+		angle_profile->plan(start, degrees - start, MAX_VELOCITY, MAX_ACCELERATION, MAX_JERK);
+		profile_start_time = Timer::GetFPGATimestamp();
+		
+		pid_manager->setProfiledTarget(start, 0.0);
 		enablePID(OI::isPIDEnabled());
 		setState(State::REACHING_ANGLE);
 	}
 	
+	bool atAngle()
+	{
+		bool profile_done = !angle_actuator->isEnabled() || Timer::GetFPGATimestamp() - profile_start_time >= angle_profile->getDuration();
+		return state == State::REACHING_ANGLE && profile_done && fabs(goal_angle - Sensors::getShooterAngle()) < ACCEPTABLE_ERROR;
+	}
+	
 	void interrupt()
 	{
 		enablePID(false);
@@ -182,6 +272,15 @@ namespace ShooterPitch
 		return ANGLE_PRESETS[index];
 	}
 	
+	float stopAtHome(float speed)
+	{
+		// don't drive the shooter down into its limit switch
+		if (speed < 0.0 && Sensors::isShooterLimitPressed()) {
+			return 0.0;
+		}
+		return speed;
+	}
+	
 	void setState(State new_state)
 	{
 		if (new_state != state) {
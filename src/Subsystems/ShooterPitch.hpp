@@ -3,6 +3,11 @@
 
 #include <Utils.hpp>
 
+namespace ED
+{
+	class PIDManager;
+}
+
 namespace ShooterPitch
 {
 	enum State {
@@ -18,6 +23,7 @@ namespace ShooterPitch
 	void process();
 	void processPID();
 	void enablePID(bool enable);
+	ED::PIDManager* getPIDManager();
 
 	void setSpeed(float speed);
 	void setDirection(Utils::VerticalDirection dir);
@@ -27,6 +33,11 @@ namespace ShooterPitch
 	
 	void engageManualControl();
 	void goToAngle(float degrees);
+
+	/**
+	 * Returns whether the shooter has reached the angle given to goToAngle
+	 */
+	bool atAngle();
 	void interrupt();
 	State getState();
 	
@@ -1,19 +1,30 @@
+#include <limits>
 #include <math.h>
+#include <CANTalon.h>
+#include <ED/ClosedLoopActuator.hpp>
+#include <ED/FlywheelController.hpp>
 #include <ED/PIDManager.hpp>
 #include <Ports/Motor.hpp>
 #include <Subsystems/OI.hpp>
+#include <Subsystems/PowerBudget.hpp>
 #include <Subsystems/Sensors.hpp>
 #include <Subsystems/ShooterWheels.hpp>
 #include <Utils.hpp>
 #include <WPILib.h>
 
 const float F_COEFFICIENT = 0.00016;
+const float DERIVATIVE_FILTER_TIME = 0.05; // seconds, so tach noise doesn't reach the motors, TODO: tune
 class ShooterWheelsPID : public ED::PIDManager
 {
 public:
-	ShooterWheelsPID() : PIDManager(0.001, 0.0, 0.001)
+	ShooterWheelsPID() : PIDManager(0.001, 0.0, 0.001, F_COEFFICIENT / 5000.0)
 	{
 		autoClearAccumulatedError(true);
+		setDerivativeFilter(DERIVATIVE_FILTER_TIME);
+		
+		// the wheels need gentler gains at low rates, TODO: tune
+		addGainSlot(2000.0, { 0.0007, 0.0, 0.001, F_COEFFICIENT / 5000.0 });
+		addGainSlot(5000.0, { 0.001, 0.0, 0.001, F_COEFFICIENT / 5000.0 });
 	}
 
 protected:
@@ -24,7 +35,7 @@ protected:
 
 	float getFeedForwardOutput(float new_target)
 	{
-		return F_COEFFICIENT * (new_target / 5000.0);
+		return getF() * new_target;
 	}
 
 	void usePIDOutput(float output, float feed_forward)
@@ -56,22 +67,65 @@ namespace ShooterWheels
 	
 	const float ACCEPTABLE_RATE_ERROR = 25.0;
 	
+	// hold rates with the flywheel model rather than the PID, once the model
+	// below is measured
+	const bool USE_FLYWHEEL_MODEL = false;
+	
+	// TODO: measure, these are fit to the speed presets
+	const ED::FlywheelController::Model FLYWHEEL_MODEL = {
+		2.0, // kS, volts
+		0.002, // kV, volts per rpm
+		0.002 // kA, volts per rpm per second
+	};
+	
+	const ED::FlywheelController::Config FLYWHEEL_CONFIG = {
+		0.01, // kP, volts per rpm
+		20000.0, // process noise, rpm^2 per second
+		900.0, // measurement noise, rpm^2
+		150.0, // shot drop, rpm
+		0.3, // recovery time, seconds
+		ACCEPTABLE_RATE_ERROR, // tolerance, rpm
+		0.1 // ready time, seconds
+	};
+	
+	// used when the wheels have a CANTalon, which then runs the PID itself, TODO:
+	// the tachometer's one pulse per rotation is too coarse for the Talon's
+	// 100 ms velocity window, so it needs an encoder wired to the Talon
+	const ED::ClosedLoopActuator::Config TALON_CONFIG = {
+		ED::ClosedLoopActuator::Mode::VELOCITY,
+		CANTalon::EncRising,
+		false,
+		1.0 / 600.0, // pulses per 100 ms per rpm
+		0.0
+	};
+	
 	State state = State::WAITING;
 	
 	ShooterWheelsPID* pid_manager = nullptr;
 	SpeedController* wheels_motor = nullptr;
+	ED::ClosedLoopActuator* wheels_actuator = nullptr;
 	
 	Timer* target_timer;
 	int on_target_count = 0;
 	
+	ED::FlywheelController* flywheel_controller;
+	Timer* control_timer;
+	double last_rate_age = 0.0;
+	
 	void setState(State new_state);
+	bool isUsingFlywheelModel();
 	
 	void initialize()
 	{
 		pid_manager = new ShooterWheelsPID();
 		wheels_motor = Utils::constructMotor(MotorPorts::SHOOTER_WHEELS_MOTOR);
+		wheels_actuator = new ED::ClosedLoopActuator(wheels_motor, pid_manager, TALON_CONFIG);
+		
+		target_timer = Utils::constructTimer();
 		
-		target_timer = new Timer();
+		flywheel_controller = new ED::FlywheelController(FLYWHEEL_MODEL, FLYWHEEL_CONFIG);
+		control_timer = Utils::constructTimer();
+		control_timer->Start();
 	}
 
 	void process()
@@ -101,26 +155,52 @@ namespace ShooterWheels
 
 	void processPID()
 	{
-		pid_manager->process();
+		wheels_actuator->process();
+		
+		float period = control_timer->Get();
+		control_timer->Reset();
+		if (isUsingFlywheelModel() && state == State::MAINTAINING_RATE) {
+			// the age of the rate starts over with each tachometer pulse
+			double rate_age = Sensors::getShooterWheelRateAge();
+			bool new_measurement = rate_age < last_rate_age;
+			last_rate_age = rate_age;
+			
+			setSpeed(flywheel_controller->update(Sensors::getShooterWheelRate(), new_measurement,
+				DriverStation::GetInstance().GetBatteryVoltage(), period));
+		}
+	}
+
+	ED::PIDManager* getPIDManager()
+	{
+		return pid_manager;
 	}
 
 	void enablePID(bool enable)
 	{
-		pid_manager->enable(enable);
+		wheels_actuator->enable(enable && !isUsingFlywheelModel());
 	}
 
 	void setSpeed(float speed)
 	{
 		if (state != State::DISABLED) {
-			wheels_motor->Set(speed);
+			wheels_motor->Set(speed * PowerBudget::getScale(PowerBudget::Consumer::SHOOTER_WHEELS));
 		}
 	}
 	
 	void setRate(float rate)
 	{
-		if (OI::isPIDEnabled()) {
-			pid_manager->enable(true);
+		if (OI::isPIDEnabled() && isUsingFlywheelModel()) {
+			if (state != State::MAINTAINING_RATE) {
+				flywheel_controller->reset(Sensors::getShooterWheelRate());
+				last_rate_age = Sensors::getShooterWheelRateAge();
+			}
+			flywheel_controller->setTarget(rate);
+			
+			setState(State::MAINTAINING_RATE);
+		}
+		else if (OI::isPIDEnabled()) {
 			pid_manager->setTarget(rate);
+			wheels_actuator->enable(true);
 			
 			target_timer->Start();
 			target_timer->Reset();
@@ -170,9 +250,24 @@ namespace ShooterWheels
 	
 	bool atRate()
 	{
+		if (isUsingFlywheelModel()) {
+			return flywheel_controller->isReady() && state == State::MAINTAINING_RATE;
+		}
 		return on_target_count > 5 && state == State::MAINTAINING_RATE;
 	}
 	
+	float getTimeToReady()
+	{
+		if (state != State::MAINTAINING_RATE) {
+			return std::numeric_limits<float>::infinity(); // there's no rate to be ready at
+		}
+		if (isUsingFlywheelModel()) {
+			return flywheel_controller->getTimeToReady(DriverStation::GetInstance().GetBatteryVoltage());
+		}
+		// the PID has no model to predict with
+		return atRate() ? 0.0 : std::numeric_limits<float>::infinity();
+	}
+	
 	void interrupt()
 	{
 		setState(State::WAITING);
@@ -188,6 +283,12 @@ namespace ShooterWheels
 		return state;
 	}
 	
+	bool isUsingFlywheelModel()
+	{
+		// a Talon's own loop is faster than the model run from the roboRIO
+		return USE_FLYWHEEL_MODEL && !wheels_actuator->isOffloaded();
+	}
+	
 	void setState(State new_state)
 	{
 		if (state != new_state) {
@@ -199,7 +300,11 @@ namespace ShooterWheels
 				break;
 			
 			case State::MANUAL_CONTROL:
+				setSpeed(0.0);
+				break;
+			
 			case State::MAINTAINING_RATE:
+				flywheel_controller->setTarget(0.0);
 				setSpeed(0.0);
 				break;
 			}
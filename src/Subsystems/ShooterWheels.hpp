@@ -1,6 +1,11 @@
 #ifndef SRC_SHOOTERWHEELS_H_
 #define SRC_SHOOTERWHEELS_H_
 
+namespace ED
+{
+	class PIDManager;
+}
+
 namespace ShooterWheels
 {
 	enum State {
@@ -14,12 +19,19 @@ namespace ShooterWheels
 	void process();
 	void processPID();
 	void enablePID(bool enable);
+	ED::PIDManager* getPIDManager();
 
 	void setSpeed(float speed);
 	void setRate(float rate);
 	float getSpeed();
 	bool atRate();
 	
+	/**
+	 * Returns the seconds until the wheels will be at their rate, or infinity
+	 * if they aren't holding a rate, or it can't be predicted or reached
+	 */
+	float getTimeToReady();
+	
 	void interrupt();
 	void engageManualControl();
 	State getState();
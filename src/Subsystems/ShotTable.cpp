@@ -0,0 +1,183 @@
+#include <ED/MonotoneCubic.hpp>
+#include <Subsystems/ShotTable.hpp>
+#include <Utils.hpp>
+#include <WPILib.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+namespace ShotTable
+{
+	/*
+	 * The table file has one shot per line, as comma separated distance, pitch,
+	 * rate and time of flight, sorted by distance.  Blank lines and lines
+	 * starting with # are skipped.
+	 */
+	const char* const TABLE_PATH = "/home/lvuser/shots.csv";
+	const double RELOAD_CHECK_PERIOD = 1.0; // seconds between checks for a changed file
+
+	/*
+	 * Used until the file is loaded, and if it can't be.
+	 * TODO: replace with measured shots
+	 */
+	constexpr Entry DEFAULT_SHOTS[] = {
+		{ 150.0, { 60.0, 2600.0, 0.30 } },
+		{ 250.0, { 50.0, 3200.0, 0.40 } },
+		{ 350.0, { 42.0, 3800.0, 0.50 } },
+		{ 450.0, { 36.0, 4400.0, 0.62 } },
+		{ 550.0, { 32.0, 5000.0, 0.75 } }
+	};
+	constexpr int DEFAULT_SHOT_COUNT = sizeof(DEFAULT_SHOTS) / sizeof(*DEFAULT_SHOTS);
+
+	constexpr bool isSorted(const Entry* entries, int count)
+	{
+		return count < 2 || (entries[0].distance < entries[1].distance && isSorted(entries + 1, count - 1));
+	}
+	static_assert(DEFAULT_SHOT_COUNT >= 2 && DEFAULT_SHOT_COUNT <= ED::MonotoneCubic::MAX_POINTS, "too few or too many default shots");
+	static_assert(isSorted(DEFAULT_SHOTS, DEFAULT_SHOT_COUNT), "default shots must be sorted by distance");
+
+	ED::MonotoneCubic* pitch_curve;
+	ED::MonotoneCubic* rate_curve;
+	ED::MonotoneCubic* time_of_flight_curve;
+
+	bool using_defaults = true;
+	time_t loaded_modification_time = 0;
+	Timer* reload_timer;
+
+	bool load();
+	bool fit(const Entry* entries, int count);
+
+	void initialize()
+	{
+		pitch_curve = new ED::MonotoneCubic();
+		rate_curve = new ED::MonotoneCubic();
+		time_of_flight_curve = new ED::MonotoneCubic();
+
+		reload_timer = Utils::constructTimer();
+		reload_timer->Start();
+
+		fit(DEFAULT_SHOTS, DEFAULT_SHOT_COUNT);
+		using_defaults = true;
+
+		struct stat status;
+		if (stat(TABLE_PATH, &status) == 0) {
+			loaded_modification_time = status.st_mtime;
+			load();
+		}
+		else {
+			DriverStation::ReportError("no shot table file, using the built in shots");
+		}
+	}
+
+	void process()
+	{
+
+	}
+
+	Shot getShot(float distance)
+	{
+		Shot shot;
+		shot.pitch = pitch_curve->evaluate(distance);
+		shot.rate = rate_curve->evaluate(distance);
+		shot.time_of_flight = time_of_flight_curve->evaluate(distance);
+		return shot;
+	}
+
+	void reloadIfChanged()
+	{
+		if (!DriverStation::GetInstance().IsDisabled() || reload_timer->Get() < RELOAD_CHECK_PERIOD) {
+			return;
+		}
+		reload_timer->Reset();
+
+		struct stat status;
+		if (stat(TABLE_PATH, &status) != 0 || status.st_mtime == loaded_modification_time) {
+			return;
+		}
+		loaded_modification_time = status.st_mtime;
+		if (load()) {
+			DriverStation::ReportError("reloaded the shot table");
+		}
+	}
+
+	bool isUsingDefaults()
+	{
+		return using_defaults;
+	}
+
+	bool load()
+	{
+		// a table with a mistake in it is reported and ignored, keeping the shots
+		// that were already loaded
+		FILE* file = fopen(TABLE_PATH, "r");
+		if (file == nullptr) {
+			DriverStation::ReportError("couldn't open the shot table file");
+			return false;
+		}
+
+		Entry entries[ED::MonotoneCubic::MAX_POINTS];
+		int count = 0;
+		char line[128];
+		char message[160];
+		int line_number = 0;
+		bool ok = true;
+		while (ok && fgets(line, sizeof(line), file) != nullptr) {
+			++line_number;
+
+			char first = ' ';
+			sscanf(line, " %c", &first);
+			if (first == '#' || first == ' ') {
+				continue; // a comment or a blank line
+			}
+
+			Entry entry;
+			if (sscanf(line, " %f , %f , %f , %f", &entry.distance, &entry.shot.pitch, &entry.shot.rate, &entry.shot.time_of_flight) != 4) {
+				snprintf(message, sizeof(message), "shot table line %d should be distance, pitch, rate, time of flight", line_number);
+				ok = false;
+			}
+			else if (count == ED::MonotoneCubic::MAX_POINTS) {
+				snprintf(message, sizeof(message), "shot table has more than %d shots", ED::MonotoneCubic::MAX_POINTS);
+				ok = false;
+			}
+			else if (count > 0 && !(entry.distance > entries[count - 1].distance)) {
+				snprintf(message, sizeof(message), "shot table line %d is out of order by distance", line_number);
+				ok = false;
+			}
+			else {
+				entries[count++] = entry;
+			}
+		}
+		fclose(file);
+
+		if (ok && count < 2) {
+			snprintf(message, sizeof(message), "shot table needs at least 2 shots");
+			ok = false;
+		}
+		if (!ok) {
+			DriverStation::ReportError(message);
+			return false;
+		}
+
+		fit(entries, count);
+		using_defaults = false;
+		return true;
+	}
+
+	bool fit(const Entry* entries, int count)
+	{
+		float distances[ED::MonotoneCubic::MAX_POINTS];
+		float pitches[ED::MonotoneCubic::MAX_POINTS];
+		float rates[ED::MonotoneCubic::MAX_POINTS];
+		float times_of_flight[ED::MonotoneCubic::MAX_POINTS];
+		for (int i = 0; i < count; ++i) {
+			distances[i] = entries[i].distance;
+			pitches[i] = entries[i].shot.pitch;
+			rates[i] = entries[i].shot.rate;
+			times_of_flight[i] = entries[i].shot.time_of_flight;
+		}
+
+		// the entries were already checked, so these all succeed or all fail together
+		return pitch_curve->fit(distances, pitches, count) &&
+			rate_curve->fit(distances, rates, count) &&
+			time_of_flight_curve->fit(distances, times_of_flight, count);
+	}
+}
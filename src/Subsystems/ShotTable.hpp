@@ -0,0 +1,48 @@
+#ifndef SRC_SUBSYSTEMS_SHOTTABLE_H_
+#define SRC_SUBSYSTEMS_SHOTTABLE_H_
+
+namespace ShotTable
+{
+	/*
+	 * The shooter settings that score from some distance to the goal, as found
+	 * by practice shots.  Distances are in centimeters from the camera to the
+	 * goal, as given by Cameras::getDistanceFromTarget().
+	 */
+	struct Shot {
+		float pitch; // degrees
+		float rate; // rpm
+		float time_of_flight; // seconds from leaving the shooter to reaching the goal
+	};
+
+	struct Entry {
+		float distance;
+		Shot shot;
+	};
+
+	void initialize();
+	void process();
+
+	/**
+	 * Returns the shot for a distance, smoothly interpolated between the
+	 * measured shots.  Distances beyond the ends of the table get the shot at
+	 * that end.
+	 */
+	Shot getShot(float distance);
+
+	/**
+	 * Loads the table file again if it has changed since it was last loaded.
+	 * This only does anything while the robot is disabled, so the shots can't
+	 * change during a match.  If the file has a mistake in it, the mistake is
+	 * reported to the driver station and the shots already in use are kept,
+	 * which at startup are the ones built into the code.
+	 */
+	void reloadIfChanged();
+
+	/**
+	 * Returns whether the shots are the ones built into the code, because the
+	 * file couldn't be loaded
+	 */
+	bool isUsingDefaults();
+}
+
+#endif /* SRC_SUBSYSTEMS_SHOTTABLE_H_ */
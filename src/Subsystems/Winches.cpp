@@ -1,4 +1,5 @@
 #include <Ports/Motor.hpp>
+#include <Subsystems/PowerBudget.hpp>
 #include <Subsystems/Winches.hpp>
 #include <Utils.hpp>
 #include <WPILib.h>
@@ -23,12 +24,12 @@ namespace Winches
 
 	void setFrontSpeed(float speed)
 	{
-		front_winch->Set(speed);
+		front_winch->Set(speed * PowerBudget::getScale(PowerBudget::Consumer::WINCHES));
 	}
 
 	void setBackSpeed(float speed)
 	{
-		back_winch->Set(-speed);
+		back_winch->Set(-speed * PowerBudget::getScale(PowerBudget::Consumer::WINCHES));
 	}
 
 	void setFrontDirection(Utils::VerticalDirection dir)
@@ -0,0 +1,165 @@
+#include <Profiler.hpp>
+#include <Trace.hpp>
+#include <WPILib.h>
+#include <atomic>
+#include <stdio.h>
+
+namespace Trace
+{
+	const int MAX_THREADS = 8;
+	const uint32_t EVENTS = 16384; // per thread, about a second of the main loop
+
+	struct Event {
+		const char* name;
+		uint64_t start;
+		uint32_t duration;
+	};
+
+	/**
+	 * Only its own thread records into a buffer, so the count of events written
+	 * is all that readers need to synchronize on
+	 */
+	struct Buffer {
+		const char* thread_name;
+		std::atomic<uint32_t> trace; // the trace the events are from
+		std::atomic<uint32_t> written; // events recorded in that trace, of which the last EVENTS are kept
+		Event events[EVENTS];
+	};
+
+	// nothing here needs constructing, for threads that start before main
+	Buffer buffers[MAX_THREADS];
+	std::atomic<int> buffer_count(0);
+	thread_local Buffer* buffer = nullptr;
+	thread_local bool buffer_missing = false; // for threads that didn't get one, so they only look once
+
+	std::atomic<bool> tracing(false);
+	std::atomic<uint32_t> current_trace(0);
+	std::atomic<uint64_t> trace_start(0);
+
+	Buffer* getBuffer()
+	{
+		if (buffer == nullptr && !buffer_missing) {
+			int index = buffer_count.fetch_add(1, std::memory_order_relaxed);
+			if (index < MAX_THREADS) {
+				buffer = &buffers[index];
+			}
+			else {
+				buffer_missing = true;
+			}
+		}
+		return buffer;
+	}
+
+	Scope::Scope(const char* name) :
+		name(name),
+		start(Profiler::now())
+	{
+
+	}
+
+	Scope::~Scope()
+	{
+		record(name, start, Profiler::now());
+	}
+
+	void nameThread(const char* name)
+	{
+		Buffer* thread_buffer = getBuffer();
+		if (thread_buffer != nullptr) {
+			thread_buffer->thread_name = name;
+		}
+	}
+
+	void start()
+	{
+		// buffers from the last trace are reset by their own threads, the next
+		// time they record
+		trace_start.store(Profiler::now(), std::memory_order_relaxed);
+		current_trace.fetch_add(1, std::memory_order_relaxed);
+		tracing.store(true, std::memory_order_release);
+	}
+
+	void stop()
+	{
+		tracing.store(false, std::memory_order_relaxed);
+	}
+
+	bool isTracing()
+	{
+		return tracing.load(std::memory_order_relaxed);
+	}
+
+	void record(const char* name, uint64_t start, uint64_t end)
+	{
+		if (!tracing.load(std::memory_order_acquire)) {
+			return;
+		}
+		Buffer* thread_buffer = getBuffer();
+		if (thread_buffer == nullptr) {
+			return;
+		}
+
+		uint32_t trace = current_trace.load(std::memory_order_relaxed);
+		uint32_t written = thread_buffer->written.load(std::memory_order_relaxed);
+		if (thread_buffer->trace.load(std::memory_order_relaxed) != trace) {
+			written = 0;
+			thread_buffer->written.store(0, std::memory_order_relaxed);
+			thread_buffer->trace.store(trace, std::memory_order_release);
+		}
+
+		Event& event = thread_buffer->events[written % EVENTS];
+		event.name = name;
+		event.start = start;
+		event.duration = end - start > 0xFFFFFFFF ? 0xFFFFFFFF : end - start;
+		thread_buffer->written.store(written + 1, std::memory_order_release);
+	}
+
+	bool write(const char* path)
+	{
+		FILE* file = fopen(path, "w");
+		if (file == nullptr) {
+			DriverStation::ReportError("couldn't write the trace file");
+			return false;
+		}
+
+		uint32_t trace = current_trace.load(std::memory_order_relaxed);
+		uint64_t origin = trace_start.load(std::memory_order_relaxed);
+
+		bool ok = fprintf(file, "{\"traceEvents\":[\n") > 0;
+		bool first = true;
+		int count = buffer_count.load(std::memory_order_relaxed);
+		for (int i = 0; i < count && i < MAX_THREADS && ok; ++i) {
+			const Buffer& thread_buffer = buffers[i];
+			if (thread_buffer.trace.load(std::memory_order_acquire) != trace) {
+				continue; // nothing recorded on this thread during the trace
+			}
+
+			char unnamed[16];
+			const char* thread_name = thread_buffer.thread_name;
+			if (thread_name == nullptr) {
+				snprintf(unnamed, sizeof(unnamed), "thread %d", i);
+				thread_name = unnamed;
+			}
+			ok = fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+				first ? "" : ",\n", i, thread_name) > 0;
+			first = false;
+
+			// a thread that was in the middle of recording when the trace stopped
+			// can still overwrite the oldest event as it's written out
+			uint32_t written = thread_buffer.written.load(std::memory_order_acquire);
+			uint32_t oldest = written > EVENTS ? written - EVENTS : 0;
+			for (uint32_t j = oldest; j < written && ok; ++j) {
+				const Event& event = thread_buffer.events[j % EVENTS];
+				ok = fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+					event.name, (int64_t)(event.start - origin) / 1000.0, event.duration / 1000.0, i) > 0;
+			}
+		}
+		ok = ok && fprintf(file, "\n]}\n") > 0;
+
+		if (fclose(file) != 0 || !ok) {
+			DriverStation::ReportError("couldn't write the whole trace file");
+			return false;
+		}
+		return true;
+	}
+}
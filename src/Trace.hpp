@@ -0,0 +1,64 @@
+#ifndef SRC_TRACE_H_
+#define SRC_TRACE_H_
+
+#include <stdint.h>
+
+/**
+ * Records a timeline of what every thread was doing, for when the profiler's
+ * histograms show a slow section but not what it was waiting on.
+ *
+ * While tracing, each section the profiler times, and each scope traced on
+ * the navX and other background threads, is recorded as an event with its
+ * start and duration.  Every thread records into a ring buffer of its own,
+ * without locks, which keeps its latest events.  write saves them as a Chrome
+ * trace, which chrome://tracing and ui.perfetto.dev open as a timeline with a
+ * row for every thread.
+ *
+ * Event names must be string literals, or otherwise outlive the trace.
+ */
+namespace Trace
+{
+	/**
+	 * Records events from construction to destruction, while tracing
+	 */
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name);
+		~Scope();
+
+	private:
+		const char* name;
+		uint64_t start;
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	/**
+	 * Names the calling thread's row in the trace
+	 */
+	void nameThread(const char* name);
+
+	/**
+	 * Starts recording, forgetting the events of the last trace
+	 */
+	void start();
+	void stop();
+	bool isTracing();
+
+	/**
+	 * @param start the monotonic time the event started, from Profiler::now
+	 * @param end   the monotonic time the event ended
+	 */
+	void record(const char* name, uint64_t start, uint64_t end);
+
+	/**
+	 * Writes the events of the last trace to a Chrome trace JSON file, which
+	 * must be done after it's stopped
+	 * @return whether the whole file was written
+	 */
+	bool write(const char* path);
+}
+
+#endif /* SRC_TRACE_H_ */
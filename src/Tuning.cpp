@@ -0,0 +1,231 @@
+#include <Characterization.hpp>
+#include <ED/PIDAutotuner.hpp>
+#include <ED/PIDManager.hpp>
+#include <Subsystems/IntakeAngle.hpp>
+#include <Subsystems/ShooterPitch.hpp>
+#include <Subsystems/ShooterWheels.hpp>
+#include <Tuning.hpp>
+#include <Utils.hpp>
+#include <WPILib.h>
+#include <stdio.h>
+#include <string.h>
+
+// get access to pi const: M_PI
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+namespace Tuning
+{
+	/*
+	 * The gains file has one mechanism per line, as its name followed by the
+	 * p, i, d and feed-forward gains, separated by spaces.  Only mechanisms
+	 * that have been tuned are in it; the rest keep the gains (and gain
+	 * schedules) in the code, since setting gains from the file replaces a
+	 * schedule.
+	 */
+	const char* const GAINS_PATH = "/home/lvuser/gains.txt";
+
+	/*
+	 * How the feed-forward of each PID scales with its target: the arms hold
+	 * against gravity, which pulls hardest when they're level, and the
+	 * wheels' feed-forward is in proportion to their rate.
+	 */
+	float cosineOfAngle(float degrees)
+	{
+		return cos(degrees * M_PI / 180.0);
+	}
+
+	float rate(float rpm)
+	{
+		return rpm;
+	}
+
+	struct Tunable {
+		const char* name;
+		ED::PIDManager* (*getPIDManager)();
+		ED::PIDAutotuner::Config config;
+	};
+
+	// in the same order as Mechanism, skipping NONE and stopping before DRIVETRAIN
+	const Tunable TUNABLES[] = {
+		{ "intake_angle", IntakeAngle::getPIDManager, {
+			30.0, // target, degrees
+			0.3, // relay amplitude
+			0.0, // initial bias
+			1.0, // hysteresis, degrees
+			4, // cycles
+			40.0, // max error, degrees
+			20.0, // timeout, seconds
+			ED::PIDAutotuner::Rule::PID,
+			cosineOfAngle // feed-forward scale
+		} },
+		{ "shooter_pitch", ShooterPitch::getPIDManager, {
+			30.0, // target, degrees
+			0.3, // relay amplitude
+			0.0, // initial bias
+			0.5, // hysteresis, degrees
+			4, // cycles
+			30.0, // max error, degrees
+			20.0, // timeout, seconds
+			ED::PIDAutotuner::Rule::PID,
+			cosineOfAngle // feed-forward scale
+		} },
+		{ "shooter_wheels", ShooterWheels::getPIDManager, {
+			3000.0, // target, rpm
+			0.15, // relay amplitude
+			0.7, // initial bias
+			50.0, // hysteresis, rpm
+			5, // cycles
+			1500.0, // max error, rpm
+			30.0, // timeout, seconds
+			ED::PIDAutotuner::Rule::PI,
+			rate // feed-forward scale
+		} }
+	};
+	const int TUNABLE_COUNT = sizeof(TUNABLES) / sizeof(*TUNABLES);
+
+	// the gains in the file, by mechanism
+	ED::PIDAutotuner::Gains saved_gains[TUNABLE_COUNT];
+	bool has_saved_gains[TUNABLE_COUNT] = {};
+
+	const Tunable* tuning = nullptr;
+	ED::PIDAutotuner* autotuner = nullptr;
+	Timer* autotune_timer;
+
+	bool loadGains();
+	bool saveGains();
+
+	void initialize()
+	{
+		autotune_timer = Utils::constructTimer();
+		autotune_timer->Start();
+
+		loadGains();
+	}
+
+	void process()
+	{
+		Characterization::process();
+		if (autotuner == nullptr) {
+			return;
+		}
+
+		float period = autotune_timer->Get();
+		autotune_timer->Reset();
+
+		char message[256];
+		switch (autotuner->process(period)) {
+		case ED::PIDAutotuner::Status::RUNNING:
+			return;
+
+		case ED::PIDAutotuner::Status::FINISHED: {
+			ED::PIDAutotuner::Gains gains = autotuner->getGains();
+			ED::PIDManager* pid_manager = tuning->getPIDManager();
+			pid_manager->setPID(gains.p, gains.i, gains.d);
+			pid_manager->setF(gains.f);
+			saved_gains[tuning - TUNABLES] = gains;
+			has_saved_gains[tuning - TUNABLES] = true;
+			saveGains();
+
+			snprintf(message, sizeof(message), "tuned %s: ultimate gain %g, period %.3f s, p %g, i %g, d %g, f %g",
+				tuning->name, autotuner->getUltimateGain(), autotuner->getUltimatePeriod(), gains.p, gains.i, gains.d, gains.f);
+			break;
+		}
+
+		case ED::PIDAutotuner::Status::FAILED:
+			snprintf(message, sizeof(message), "couldn't tune %s after %d cycles, the gains are unchanged",
+				tuning->name, autotuner->getCycleCount());
+			break;
+		}
+		DriverStation::ReportError(message);
+
+		delete autotuner;
+		autotuner = nullptr;
+		tuning = nullptr;
+	}
+
+	void startAutotune(Mechanism mechanism)
+	{
+		stopAutotune();
+		if (mechanism == Mechanism::DRIVETRAIN) {
+			Characterization::start();
+			return;
+		}
+		if (mechanism <= Mechanism::NONE || mechanism > TUNABLE_COUNT) {
+			return;
+		}
+
+		tuning = &TUNABLES[mechanism - 1];
+		ED::PIDManager* pid_manager = tuning->getPIDManager();
+		pid_manager->enable(false);
+		autotuner = new ED::PIDAutotuner(*pid_manager, tuning->config);
+		autotune_timer->Reset();
+
+		char message[128];
+		snprintf(message, sizeof(message), "tuning %s", tuning->name);
+		DriverStation::ReportError(message);
+	}
+
+	void stopAutotune()
+	{
+		Characterization::stop();
+		if (autotuner != nullptr) {
+			autotuner->stop();
+			delete autotuner;
+			autotuner = nullptr;
+			tuning = nullptr;
+		}
+	}
+
+	bool isAutotuning()
+	{
+		return autotuner != nullptr || Characterization::isRunning();
+	}
+
+	bool loadGains()
+	{
+		FILE* file = fopen(GAINS_PATH, "r");
+		if (file == nullptr) {
+			return false; // the gains in the code are used until some are tuned
+		}
+
+		char line[128];
+		char name[32];
+		ED::PIDAutotuner::Gains gains;
+		while (fgets(line, sizeof(line), file) != nullptr) {
+			if (sscanf(line, "%31s %f %f %f %f", name, &gains.p, &gains.i, &gains.d, &gains.f) != 5) {
+				continue;
+			}
+			for (int i = 0; i < TUNABLE_COUNT; ++i) {
+				if (strcmp(name, TUNABLES[i].name) == 0) {
+					ED::PIDManager* pid_manager = TUNABLES[i].getPIDManager();
+					pid_manager->setPID(gains.p, gains.i, gains.d);
+					pid_manager->setF(gains.f);
+					saved_gains[i] = gains;
+					has_saved_gains[i] = true;
+				}
+			}
+		}
+		fclose(file);
+		return true;
+	}
+
+	bool saveGains()
+	{
+		// every mechanism in the file is written back, so tuning one keeps the
+		// others' tuned gains without fixing the untuned ones to a single slot
+		FILE* file = fopen(GAINS_PATH, "w");
+		if (file == nullptr) {
+			DriverStation::ReportError("couldn't save the gains file");
+			return false;
+		}
+		for (int i = 0; i < TUNABLE_COUNT; ++i) {
+			if (has_saved_gains[i]) {
+				const ED::PIDAutotuner::Gains& gains = saved_gains[i];
+				fprintf(file, "%s %.9g %.9g %.9g %.9g\n", TUNABLES[i].name, gains.p, gains.i, gains.d, gains.f);
+			}
+		}
+		fclose(file);
+		return true;
+	}
+}
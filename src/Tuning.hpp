@@ -0,0 +1,37 @@
+#ifndef SRC_TUNING_H_
+#define SRC_TUNING_H_
+
+/**
+ * Keeps the PID gains of the mechanisms in a file on the roboRIO, and finds
+ * new ones in test mode with ED::PIDAutotuner.
+ *
+ * The gains in the code are only a starting point: initialize() replaces
+ * them, and any gain schedule, with those found in the file.  In test mode,
+ * the autonomous position switch picks a mechanism to tune, which then
+ * oscillates around a target until its gains are found, and the new gains
+ * are used and saved straight away.  Disabling the robot stops the tuning.
+ *
+ * Picking the drive train runs Characterization instead.
+ */
+namespace Tuning
+{
+	enum Mechanism {
+		NONE,
+		INTAKE_ANGLE,
+		SHOOTER_PITCH,
+		SHOOTER_WHEELS,
+		DRIVETRAIN
+	};
+
+	/**
+	 * Loads the gains file, must come after the mechanisms are initialized
+	 */
+	void initialize();
+	void process();
+
+	void startAutotune(Mechanism mechanism);
+	void stopAutotune();
+	bool isAutotuning();
+}
+
+#endif /* SRC_TUNING_H_ */
@@ -1,9 +1,19 @@
 #include <Utils.hpp>
 #include <CANTalon.h>
+#include <ED/StaticPool.hpp>
+#include <Outputs.hpp>
 #include <WPILib.h>
 
 namespace Utils
 {
+	const int MAX_MOTORS = 16;
+	const int MAX_TIMERS = 16;
+	
+	// these are used during static initialization, so they can't need constructing
+	ED::StaticPool<CANTalon, MAX_MOTORS> talon_pool;
+	ED::StaticPool<VictorSP, MAX_MOTORS> victor_pool;
+	ED::StaticPool<Timer, MAX_TIMERS> timer_pool;
+	
 	MotorType getMotorType()
 	{
 		return MotorType::VICTOR_SP;
@@ -11,18 +21,38 @@ namespace Utils
 
 	SpeedController* constructMotor(unsigned int port)
 	{
+		SpeedController* motor = nullptr;
 		if (getMotorType() == MotorType::CAN_TALON)
 		{
-			return new CANTalon(port + 1);
+			motor = talon_pool.make(port + 1);
+			if (motor == nullptr) {
+				DriverStation::ReportError("out of motors, raise Utils::MAX_MOTORS");
+				motor = new CANTalon(port + 1);
+			}
 		}
 		else if (getMotorType() == MotorType::VICTOR_SP)
 		{
-			return new VictorSP(port);
+			motor = victor_pool.make(port);
+			if (motor == nullptr) {
+				DriverStation::ReportError("out of motors, raise Utils::MAX_MOTORS");
+				motor = new VictorSP(port);
+			}
 		}
 		else
 		{
 			// Log::getInstance()->write(Log::ERROR_LEVEL, "Unable to construct motor because of unknown motor type");
 			return nullptr;
 		}
+		return Outputs::add(port, motor);
+	}
+
+	Timer* constructTimer()
+	{
+		Timer* timer = timer_pool.make();
+		if (timer == nullptr) {
+			DriverStation::ReportError("out of timers, raise Utils::MAX_TIMERS");
+			timer = new Timer();
+		}
+		return timer;
 	}
 }
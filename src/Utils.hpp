@@ -36,9 +36,16 @@ namespace Utils
 
 	/**
 	 * Constructs either a CANTalon or VictorSP motor controller
-	 * depending on getMotorType()
+	 * depending on getMotorType(), buffered by Outputs so that
+	 * it's only written to when Outputs::flush() is called
 	 */
 	SpeedController* constructMotor(unsigned int port);
+
+	/**
+	 * Constructs a Timer from static storage, so that subsystems
+	 * don't take their timers from the heap
+	 */
+	Timer* constructTimer();
 }
 
 #endif /* SRC_UTILS_H_ */
@@ -0,0 +1,88 @@
+/*
+ * Checks ED::MotionProfile and the straight trajectories made from it on a
+ * desktop: every profile must have a finite duration and end exactly at its
+ * target, at rest, including moves of no distance at all.  Exits non-zero if
+ * any check fails.
+ *
+ * From the root of the project:
+ *
+ *   g++ -std=c++11 -O2 -Isrc -o MotionProfileCheck tools/MotionProfileCheck/MotionProfileCheck.cpp \
+ *       src/ED/MotionProfile.cpp src/ED/Trajectory.cpp src/ED/TrajectoryGenerator.cpp src/ED/Utils.cpp
+ *   ./MotionProfileCheck
+ */
+#include <ED/MotionProfile.hpp>
+#include <ED/Trajectory.hpp>
+#include <ED/TrajectoryGenerator.hpp>
+#include <math.h>
+#include <stdio.h>
+
+const float MAX_VELOCITY = 300.0;
+const float MAX_ACCELERATION = 250.0;
+const float MAX_JERK = 1500.0;
+const float PERIOD = 0.01;
+
+int failures = 0;
+
+void check(bool passed, const char* name, float distance, float max_jerk)
+{
+	if (!passed) {
+		printf("FAILED: %s, distance %g, max jerk %g\n", name, distance, max_jerk);
+		++failures;
+	}
+}
+
+void checkProfile(float start, float distance, float max_jerk)
+{
+	ED::MotionProfile profile;
+	profile.plan(start, distance, MAX_VELOCITY, MAX_ACCELERATION, max_jerk);
+
+	float duration = profile.getDuration();
+	check(isfinite(duration) && duration >= 0.0, "finite duration", distance, max_jerk);
+	check(distance != 0.0 || duration == 0.0, "no time for no distance", distance, max_jerk);
+	check(profile.getEnd() == start + distance, "end", distance, max_jerk);
+
+	ED::MotionProfile::State state = profile.sample(duration);
+	check(fabs(state.position - (start + distance)) < 0.01, "reaches the end", distance, max_jerk);
+	check(state.velocity == 0.0 && state.acceleration == 0.0, "stops at the end", distance, max_jerk);
+
+	// partway through, the profile never runs past its limits or its target
+	for (float time = 0.0; time < duration; time += PERIOD / 4.0) {
+		state = profile.sample(time);
+		if (!(fabs(state.velocity) <= MAX_VELOCITY * 1.001 && fabs(state.acceleration) <= MAX_ACCELERATION * 1.001 &&
+		    fabs(state.position - start) <= fabs(distance) + 0.01)) {
+			check(false, "stays within its limits", distance, max_jerk);
+			break;
+		}
+	}
+}
+
+int main()
+{
+	const float distances[] = { 0.0, 0.5, 5.0, 50.0, 500.0, -200.0 };
+	const float jerks[] = { 0.0, MAX_JERK };
+	for (float distance : distances) {
+		for (float jerk : jerks) {
+			checkProfile(10.0, distance, jerk);
+		}
+	}
+
+	ED::TrajectoryGenerator::Limits limits = { MAX_VELOCITY, MAX_ACCELERATION, MAX_JERK, 150.0 };
+	static ED::TrajectoryGenerator generator(limits, PERIOD);
+	static ED::Trajectory trajectory;
+	ED::TrajectoryGenerator::Waypoint start = { 100.0, 200.0, 90.0 };
+	for (float distance : distances) {
+		bool generated = generator.generateStraight(trajectory, start, distance);
+		check(generated && trajectory.getCount() > 0, "generates a straight trajectory", distance, MAX_JERK);
+		if (generated) {
+			const ED::Trajectory::Sample& last = trajectory.getSample(trajectory.getCount() - 1);
+			check(fabs(last.distance - distance) < 0.01, "straight trajectory reaches the end", distance, MAX_JERK);
+		}
+	}
+
+	if (failures > 0) {
+		printf("%d checks failed\n", failures);
+		return 1;
+	}
+	printf("all checks passed\n");
+	return 0;
+}
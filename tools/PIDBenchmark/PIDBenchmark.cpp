@@ -0,0 +1,174 @@
+/*
+ * Times ED::PIDManager, which calls its subclass through virtual functions
+ * and locks mutexes, against ED::PIDController, which is inlined at compile
+ * time, each closing the same loop around a simulated flywheel.  Build it
+ * with the same optimization as the robot program, and run it on the roboRIO
+ * for numbers that mean anything.
+ *
+ * From the root of the project:
+ *
+ *   arm-frc-linux-gnueabi-g++ -std=c++11 -O2 -Isrc -o PIDBenchmark tools/PIDBenchmark/PIDBenchmark.cpp \
+ *       src/ED/PIDManager.cpp -pthread
+ *   scp PIDBenchmark lvuser@roborio-116-frc.local:/home/lvuser/
+ *   ssh lvuser@roborio-116-frc.local ./PIDBenchmark
+ */
+#include <ED/PIDController.hpp>
+#include <ED/PIDManager.hpp>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+const int LOOPS = 1000000;
+const float CYCLE_TIME = 0.005;
+
+// both controllers filter the derivative and clamp the integral the same way
+const float DERIVATIVE_TIME_CONSTANT = 0.02; // seconds
+const float MAX_ACCUMULATED_ERROR = 1000.0; // rpm seconds
+
+// the clock times each controller's cycles differently, so they only agree
+// to within the tachometer noise
+const float EQUIVALENCE_TOLERANCE = 50.0; // rpm
+
+/**
+ * a flywheel that the motor speeds up and friction slows down, with a noisy
+ * tachometer
+ *
+ * The controllers that read the clock see cycles of well under a microsecond,
+ * which makes their derivative terms huge, so the output is limited the way a
+ * motor controller would.  The noise keeps the loops from settling into
+ * denormal numbers, which real sensors never do either.
+ */
+struct Plant {
+	float rpm;
+	unsigned int noise_state;
+
+	void step(float output)
+	{
+		output = output > 1.0 ? 1.0 : (output < -1.0 ? -1.0 : output);
+		rpm += CYCLE_TIME * (5000.0 * output - 2.0 * rpm);
+	}
+
+	float measure()
+	{
+		noise_state = noise_state * 1664525 + 1013904223;
+		return rpm + (noise_state >> 16) / 65536.0 * 20.0 - 10.0;
+	}
+};
+
+class VirtualPID : public ED::PIDManager
+{
+public:
+	VirtualPID() : PIDManager(0.001, 0.0001, 0.00001, 1.0 / 5000.0)
+	{
+		plant.rpm = 0.0;
+		plant.noise_state = 1;
+		setDerivativeFilter(DERIVATIVE_TIME_CONSTANT);
+		limitAccumulatedError(-MAX_ACCUMULATED_ERROR, MAX_ACCUMULATED_ERROR);
+	}
+
+	Plant plant;
+
+protected:
+	float returnPIDInput()
+	{
+		return plant.measure();
+	}
+
+	void usePIDOutput(float pid_output, float feed_forward)
+	{
+		plant.step(pid_output + feed_forward);
+	}
+
+	float getFeedForwardOutput(float new_target)
+	{
+		return getF() * new_target;
+	}
+};
+
+class TemplatePID : public ED::PIDController<TemplatePID, ED::LowPassDerivativeFilter, ED::RangeIntegratorClamp>
+{
+public:
+	TemplatePID() : PIDController(0.001, 0.0001, 0.00001, 1.0 / 5000.0)
+	{
+		plant.rpm = 0.0;
+		plant.noise_state = 1;
+		getDerivativeFilter().setTimeConstant(DERIVATIVE_TIME_CONSTANT);
+		getIntegratorClamp().setRange(-MAX_ACCUMULATED_ERROR, MAX_ACCUMULATED_ERROR);
+	}
+
+	Plant plant;
+
+	float returnPIDInput()
+	{
+		return plant.measure();
+	}
+
+	void usePIDOutput(float pid_output, float feed_forward)
+	{
+		plant.step(pid_output + feed_forward);
+	}
+
+	float getFeedForwardOutput(float new_target)
+	{
+		return getF() * new_target;
+	}
+};
+
+template<class Function>
+double time(const char* name, Function function)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	float rpm = function();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("%-40s %7.1f ns per loop, ends at %.0f\n", name, seconds * 1e9 / LOOPS, rpm);
+	return seconds;
+}
+
+// globals, the way a subsystem would keep them, with no heap involved
+TemplatePID template_pid;
+
+int main()
+{
+	VirtualPID* virtual_pid = new VirtualPID();
+	virtual_pid->setTarget(2000.0);
+	template_pid.setTarget(2000.0);
+
+	// both process functions read the clock once a loop
+	time("steady_clock::now", [&]() {
+		float sum = 0.0;
+		for (int i = 0; i < LOOPS; ++i) {
+			sum += std::chrono::steady_clock::now().time_since_epoch().count() & 1;
+		}
+		return sum;
+	});
+	double virtual_seconds = time("PIDManager::process", [&]() {
+		for (int i = 0; i < LOOPS; ++i) {
+			virtual_pid->process();
+		}
+		return virtual_pid->plant.rpm;
+	});
+	double template_seconds = time("PIDController::process", [&]() {
+		for (int i = 0; i < LOOPS; ++i) {
+			template_pid.process();
+		}
+		return template_pid.plant.rpm;
+	});
+	float clock_template_rpm = template_pid.plant.rpm;
+	time("PIDController::process(cycle_time)", [&]() {
+		for (int i = 0; i < LOOPS; ++i) {
+			template_pid.process(CYCLE_TIME);
+		}
+		return template_pid.plant.rpm;
+	});
+
+	printf("PIDController takes %.0f%% of the time of PIDManager, both reading the clock\n",
+		100.0 * template_seconds / virtual_seconds);
+
+	// the timings only compare if both did the same work
+	float virtual_rpm = virtual_pid->plant.rpm;
+	bool equivalent = fabs(virtual_rpm - clock_template_rpm) <= EQUIVALENCE_TOLERANCE;
+	printf("PIDManager ends at %.0f rpm and PIDController at %.0f rpm, %s\n", virtual_rpm, clock_template_rpm,
+		equivalent ? "the same loop" : "NOT the same loop, the timings don't compare");
+	delete virtual_pid;
+	return equivalent ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+/*
+ * Checks ED::PIDManager against responses that are known analytically: the
+ * derivative of a ramp, the time constant of the derivative filter, the
+ * proportional and derivative target weights, the i-zone, and back
+ * calculation unwinding a saturated integral.  PIDManager times its own
+ * cycles with the clock, so each check runs in real time at about the robot
+ * loop's rate, and compares against the times it actually saw.  Exits
+ * non-zero if any check fails.
+ *
+ * From the root of the project:
+ *
+ *   g++ -std=c++11 -O2 -Isrc -o PIDStepResponse tools/PIDStepResponse/PIDStepResponse.cpp \
+ *       src/ED/PIDManager.cpp -pthread
+ *   ./PIDStepResponse
+ */
+#include <ED/PIDManager.hpp>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <thread>
+
+using namespace std::chrono;
+
+const milliseconds CYCLE(5);
+
+int failures = 0;
+
+double since(steady_clock::time_point start)
+{
+	return duration<double>(steady_clock::now() - start).count();
+}
+
+void check(const char* name, float value, float expected, float tolerance)
+{
+	bool passed = fabs(value - expected) <= tolerance;
+	printf("%-6s %-48s %10.4f, expected %10.4f +/- %g\n", passed ? "ok" : "FAILED", name, value, expected, tolerance);
+	if (!passed) {
+		++failures;
+	}
+}
+
+/**
+ * a PIDManager whose input holds still or ramps with the clock, and which
+ * keeps its last output
+ */
+class StepPID : public ED::PIDManager
+{
+public:
+	StepPID(float p, float i, float d) :
+		PIDManager(p, i, d, 0.0),
+		input(0.0),
+		output(0.0),
+		ramp_rate(0.0),
+		ramp_start(steady_clock::now())
+	{
+	}
+
+	void startRamp(float rate)
+	{
+		ramp_start = steady_clock::now();
+		ramp_rate = rate;
+	}
+
+	/**
+	 * processes once a cycle for a number of seconds, and at least once
+	 * @return the seconds it actually took, up to the last process
+	 */
+	double run(double seconds)
+	{
+		steady_clock::time_point start = steady_clock::now();
+		double elapsed;
+		do {
+			std::this_thread::sleep_for(CYCLE);
+			process();
+			elapsed = since(start);
+		} while (elapsed < seconds);
+		return elapsed;
+	}
+
+	float input;
+	float output;
+
+protected:
+	float returnPIDInput()
+	{
+		return input + ramp_rate * since(ramp_start);
+	}
+
+	void usePIDOutput(float pid_output, float feed_forward)
+	{
+		output = pid_output;
+	}
+
+private:
+	float ramp_rate;
+	steady_clock::time_point ramp_start;
+};
+
+void checkRampDerivative()
+{
+	// d (0.0 - input) / dt of an input rising at 100 per second
+	StepPID pid(0.0, 0.0, 1.0);
+	pid.startRamp(100.0);
+	pid.run(0.1);
+	check("derivative of a ramp", pid.output, -100.0, 1.0);
+}
+
+void checkDerivativeFilter()
+{
+	// the filtered derivative of a ramp that starts at rest rises as
+	// 1 - e^(-t / time constant)
+	const float TIME_CONSTANT = 0.1;
+	StepPID pid(0.0, 0.0, 1.0);
+	pid.setDerivativeFilter(TIME_CONSTANT);
+	pid.run(0.05);
+
+	pid.startRamp(100.0);
+	double elapsed = pid.run(TIME_CONSTANT);
+	check("filtered derivative after one time constant", pid.output, -100.0 * (1.0 - exp(-elapsed / TIME_CONSTANT)), 4.0);
+	elapsed += pid.run(4.0 * TIME_CONSTANT);
+	check("filtered derivative after five time constants", pid.output, -100.0 * (1.0 - exp(-elapsed / TIME_CONSTANT)), 1.5);
+}
+
+void checkTargetWeights()
+{
+	StepPID pid(1.0, 0.0, 1.0);
+	pid.setTargetWeights(0.5, 0.0);
+	pid.run(0.02);
+
+	// the proportional term sees half the step, and the derivative none of it
+	pid.setTarget(10.0);
+	pid.run(0.0);
+	check("proportional weight of a target step", pid.output, 5.0, 0.0001);
+
+	// with the whole target, the derivative kicks by the step over the cycle,
+	// timed from just after the process before it
+	pid.setTargetWeights(0.5, 1.0);
+	pid.run(0.02);
+	pid.setTarget(20.0);
+	double cycle = pid.run(0.0);
+	check("derivative weight of a target step", pid.output - 10.0, 10.0 / cycle, 0.05 * 10.0 / cycle);
+}
+
+void checkIZone()
+{
+	// outside the zone nothing accumulates, inside it the integral of a
+	// constant error is a ramp; the trapezoidal sum averages in the last error
+	// from outside the zone for one cycle, which the tolerance allows for
+	StepPID pid(0.0, 1.0, 0.0);
+	pid.setAbsoluteIZone(5.0);
+	pid.setTarget(10.0);
+	pid.run(0.2);
+	check("integral outside the i-zone", pid.output, 0.0, 0.0);
+
+	pid.setTarget(3.0);
+	double elapsed = pid.run(0.2);
+	check("integral inside the i-zone", pid.output, 3.0 * elapsed, 0.05);
+}
+
+void checkBackCalculation()
+{
+	/*
+	 * Saturated at 1.0 with an error of 10, the integral term settles where
+	 * back calculation pulls it down as fast as the error pushes it up, at
+	 * 1.0 + 10 * tracking time.  Reversing the error to -1 then unwinds it as
+	 * (integral - 1.0) = (1.0 + 0.1) e^(-t / tracking time) - 0.1, so the
+	 * output leaves saturation after tracking time * ln(11).
+	 */
+	const float TRACKING_TIME = 0.1;
+	StepPID pid(0.0, 1.0, 0.0);
+	pid.setBackCalculation(-1.0, 1.0, TRACKING_TIME);
+	pid.setTarget(10.0);
+	pid.run(0.5);
+	check("output limited while saturated", pid.output, 1.0, 0.0);
+
+	pid.setTarget(-1.0);
+	steady_clock::time_point start = steady_clock::now();
+	while (pid.output >= 1.0 && since(start) < 2.0) {
+		pid.run(0.0);
+	}
+	check("seconds to unwind a saturated integral", since(start), TRACKING_TIME * log(11.0), 0.03);
+}
+
+int main()
+{
+	checkRampDerivative();
+	checkDerivativeFilter();
+	checkTargetWeights();
+	checkIZone();
+	checkBackCalculation();
+
+	if (failures > 0) {
+		printf("%d checks failed\n", failures);
+		return 1;
+	}
+	printf("all checks passed\n");
+	return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * Generates every autonomous route in src/Routes.cpp into a trajectory cache
+ * file, so the robot doesn't have to generate them itself.  Run it on a
+ * desktop whenever a route changes, then copy the file to the robot, where
+ * Autonomous::loadTrajectories() maps it into memory at boot.  The robot
+ * refuses a file made from different routes, and falls back to generating
+ * them itself (slowly) until the file is updated.
+ *
+ * From the root of the project:
+ *
+ *   g++ -std=c++11 -O2 -Isrc -o TrajectoryBuilder tools/TrajectoryBuilder/TrajectoryBuilder.cpp \
+ *       src/Routes.cpp src/ED/MotionProfile.cpp src/ED/Trajectory.cpp src/ED/TrajectoryCache.cpp \
+ *       src/ED/TrajectoryGenerator.cpp src/ED/Utils.cpp
+ *   ./TrajectoryBuilder trajectories.bin
+ *   scp trajectories.bin lvuser@roborio-116-frc.local:/home/lvuser/
+ */
+#include <ED/Trajectory.hpp>
+#include <ED/TrajectoryCache.hpp>
+#include <ED/TrajectoryGenerator.hpp>
+#include <Routes.hpp>
+#include <stdio.h>
+
+int main(int argc, char** argv)
+{
+	const char* path = argc > 1 ? argv[1] : "trajectories.bin";
+
+	static ED::TrajectoryGenerator generator(Routes::getLimits(), Routes::getPeriod());
+	static ED::Trajectory trajectories[Routes::MAX_ROUTES];
+	const ED::Trajectory* pointers[Routes::MAX_ROUTES];
+
+	for (int i = 0; i < Routes::getRouteCount(); ++i) {
+		const Routes::Route& route = Routes::getRoute(i);
+		if (!Routes::generate(i, generator, trajectories[i])) {
+			fprintf(stderr, "route %d (play %d, position %d) could not be generated\n", i, route.play, route.position);
+			return 1;
+		}
+		pointers[i] = &trajectories[i];
+
+		const ED::Trajectory::Sample& end = trajectories[i].getSample(trajectories[i].getCount() - 1);
+		printf("route %2d: play %d, position %d, %4d samples, %5.2f s, ends at (%.1f, %.1f) facing %.1f\n",
+			i, route.play, route.position, trajectories[i].getCount(), trajectories[i].getDuration(), end.x, end.y, end.heading);
+	}
+
+	if (!ED::TrajectoryCache::write(path, Routes::getChecksum(), pointers, Routes::getRouteCount())) {
+		fprintf(stderr, "could not write %s\n", path);
+		return 1;
+	}
+	printf("wrote %d routes to %s, checksum %08x\n", Routes::getRouteCount(), path, Routes::getChecksum());
+	return 0;
+}